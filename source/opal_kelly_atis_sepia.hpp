@@ -3,526 +3,5106 @@
 #include "../resources/opalkellyfrontpanel.h"
 #include "../third_party/sepia/source/sepia.hpp"
 #include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <type_traits>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define OPAL_KELLY_ATIS_SEPIA_X86
+#include <immintrin.h>
+#endif
 
 /// opal_kelly_atis_sepia specialises sepia for the Opal Kelly ATIS.
 /// In order to use this header, an application must link to the dynamic library opalkellyfrontpanel.
 namespace opal_kelly_atis_sepia {
-    /// camera represents an ATIS connected to an Opal Kelly board.
-    class camera {
+    /// instruction_set lists the decoder implementations.
+    enum class instruction_set {
+        scalar,
+        sse2,
+        avx2,
+    };
+
+    /// best_instruction_set returns the fastest decoder implementation supported by the processor.
+    inline instruction_set best_instruction_set() {
+#ifdef OPAL_KELLY_ATIS_SEPIA_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return instruction_set::avx2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return instruction_set::sse2;
+        }
+#endif
+        return instruction_set::scalar;
+    }
+
+    /// word_at reads a little-endian pipe-out word.
+    inline uint32_t word_at(const uint8_t* data) {
+        return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8)
+               | (static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    /// compact_atis_event is an ATIS event packed in 8 bytes, instead of 14 for sepia::atis_event.
+    /// t is stored on 44 bits, hence it wraps after about 203 days of acquisition.
+    struct compact_atis_event {
+        uint64_t t : 44;
+        uint64_t x : 9;
+        uint64_t y : 8;
+        uint64_t is_threshold_crossing : 1;
+        uint64_t polarity : 1;
+    };
+
+    /// unpack converts a compact ATIS event to a sepia ATIS event.
+    inline sepia::atis_event unpack(compact_atis_event event) {
+        return {event.t,
+                static_cast<uint16_t>(event.x),
+                static_cast<uint16_t>(event.y),
+                event.is_threshold_crossing == 1,
+                event.polarity == 1};
+    }
+
+    /// decode_mode selects at compile time the events written by the decoder, so that the discarded event types
+    /// and the y flip cost nothing.
+    ///     - Event: sepia::atis_event or compact_atis_event, or sepia::dvs_event if threshold crossings are discarded
+    ///     - change_detections: keep the change detections
+    ///     - threshold_crossings: keep the threshold crossings (exposure measurements)
+    ///     - flip_y: flip y so that the origin is the bottom-left corner (the sensor's origin is the top-left one)
+    template <typename Event, bool change_detections, bool threshold_crossings, bool flip_y>
+    struct decode_mode {
+        static_assert(change_detections || threshold_crossings, "a decode mode must keep at least one event type");
+        static_assert(
+            !threshold_crossings || std::is_same<Event, sepia::atis_event>::value
+                || std::is_same<Event, compact_atis_event>::value,
+            "threshold crossings can only be represented by sepia::atis_event or compact_atis_event");
+
+        /// event is the type of the decoded events.
+        typedef Event event;
+
+        /// keep returns true if an event with the given flags (bit 0: threshold crossing) must be written.
+        static constexpr bool keep(uint32_t flags) {
+            return (flags & 1) == 1 ? threshold_crossings : change_detections;
+        }
+
+        /// select removes the lanes whose event type is discarded from a vector decoder's lane mask.
+        /// lanes_are_threshold_crossings holds one bit per lane, set for threshold crossings.
+        static constexpr uint32_t select(uint32_t lanes_are_events, uint32_t lanes_are_threshold_crossings) {
+            return lanes_are_events
+                   & ((threshold_crossings ? lanes_are_threshold_crossings : 0)
+                      | (change_detections ? ~lanes_are_threshold_crossings : 0));
+        }
+
+        /// flips_y returns true if y is flipped.
+        static constexpr bool flips_y() {
+            return flip_y;
+        }
+
+        /// discards returns true if an event type is discarded, in which case the decoders count the discarded events.
+        static constexpr bool discards() {
+            return !change_detections || !threshold_crossings;
+        }
+    };
+
+    /// atis_mode decodes every event to sepia::atis_event, and is used by default.
+    typedef decode_mode<sepia::atis_event, true, true, true> atis_mode;
+
+    /// dvs_mode decodes the change detections to sepia::dvs_event, and discards the threshold crossings.
+    typedef decode_mode<sepia::dvs_event, true, false, true> dvs_mode;
+
+    /// exposure_mode decodes the threshold crossings to sepia::atis_event, and discards the change detections.
+    typedef decode_mode<sepia::atis_event, false, true, true> exposure_mode;
+
+    /// compact_mode decodes every event to compact_atis_event, so that the host FIFO uses less memory.
+    typedef decode_mode<compact_atis_event, true, true, true> compact_mode;
+
+    /// write_event sets the fields of a decoded ATIS event.
+    /// flags holds the threshold crossing bit (bit 0) and the polarity bit (bit 1).
+    inline void write_event(sepia::atis_event* event, uint64_t t, uint16_t x, uint16_t y, uint32_t flags) {
+        event->t = t;
+        event->x = x;
+        event->y = y;
+        event->is_threshold_crossing = (flags & 1) == 1;
+        event->polarity = (flags & 2) == 2;
+    }
+
+    /// write_event sets the fields of a decoded DVS event.
+    inline void write_event(sepia::dvs_event* event, uint64_t t, uint16_t x, uint16_t y, uint32_t flags) {
+        event->t = t;
+        event->x = x;
+        event->y = y;
+        event->is_increase = (flags & 2) == 2;
+    }
+
+    /// write_event sets the fields of a decoded compact ATIS event.
+    /// The event is assembled in a register, so that the fields are stored at once.
+    inline void write_event(compact_atis_event* event, uint64_t t, uint16_t x, uint16_t y, uint32_t flags) {
+        compact_atis_event packed_event;
+        packed_event.t = t;
+        packed_event.x = x;
+        packed_event.y = y;
+        packed_event.is_threshold_crossing = flags & 1;
+        packed_event.polarity = (flags >> 1) & 1;
+        *event = packed_event;
+    }
+
+    /// decode_scalar converts pipe-out words to events.
+    /// Words outside the sensor are skipped, and overflow markers (x = 305, y = 240, t = 0x1555) increment t_offset.
+    /// events must have room for number_of_words events, and the number of events written is returned.
+    /// If number_of_discarded_events is not null, the events of a type discarded by the mode are added to it.
+    template <typename Mode = atis_mode>
+    inline std::size_t decode_scalar(
+        const uint8_t* data,
+        std::size_t number_of_words,
+        uint64_t& t_offset,
+        typename Mode::event* events,
+        std::size_t* number_of_discarded_events = nullptr) {
+        auto event = events;
+        std::size_t discarded_events = 0;
+        for (std::size_t index = 0; index < number_of_words; ++index) {
+            const auto word = word_at(data + 4 * index);
+            const auto y = static_cast<uint16_t>(word >> 24);
+            const auto x = static_cast<uint16_t>(((word >> 16) & 0xff) | ((word >> 5) & 0x100));
+            if (y < 240) {
+                if (x < 304) {
+                    if (Mode::keep(word >> 14)) {
+                        write_event(
+                            event,
+                            t_offset + (word & 0x1fff),
+                            x,
+                            static_cast<uint16_t>(Mode::flips_y() ? 239 - y : y),
+                            (word >> 14) & 3);
+                        ++event;
+                    } else if (Mode::discards()) {
+                        ++discarded_events;
+                    }
+                }
+            } else if ((word & 0xffff3fff) == 0xf0313555) {
+                t_offset += 0x2000;
+            }
+        }
+        if (number_of_discarded_events != nullptr) {
+            *number_of_discarded_events += discarded_events;
+        }
+        return static_cast<std::size_t>(event - events);
+    }
+
+#ifdef OPAL_KELLY_ATIS_SEPIA_X86
+    /// decode_lanes writes the events of a block of words decoded by a vector unit.
+    /// lanes_are_events and lanes_are_markers hold one bit per lane, as returned by movemask.
+    template <std::size_t lanes, typename Mode>
+    inline typename Mode::event* decode_lanes(
+        uint32_t lanes_are_events,
+        uint32_t lanes_are_markers,
+        const uint32_t* ts,
+        const uint32_t* xs,
+        const uint32_t* ys,
+        const uint32_t* flags,
+        uint64_t& t_offset,
+        typename Mode::event* event) {
+        if (lanes_are_markers == 0) {
+            while (lanes_are_events != 0) {
+                const auto lane = __builtin_ctz(lanes_are_events);
+                lanes_are_events &= lanes_are_events - 1;
+                write_event(
+                    event,
+                    t_offset + ts[lane],
+                    static_cast<uint16_t>(xs[lane]),
+                    static_cast<uint16_t>(ys[lane]),
+                    flags[lane]);
+                ++event;
+            }
+        } else {
+            for (std::size_t lane = 0; lane < lanes; ++lane) {
+                if ((lanes_are_markers >> lane) & 1) {
+                    t_offset += 0x2000;
+                } else if ((lanes_are_events >> lane) & 1) {
+                    write_event(
+                        event,
+                        t_offset + ts[lane],
+                        static_cast<uint16_t>(xs[lane]),
+                        static_cast<uint16_t>(ys[lane]),
+                        flags[lane]);
+                    ++event;
+                }
+            }
+        }
+        return event;
+    }
+
+    /// decode_sse2 is an SSE2 implementation of decode_scalar, processing four words at once.
+    template <typename Mode = atis_mode>
+    __attribute__((target("sse2"))) inline std::size_t decode_sse2(
+        const uint8_t* data,
+        std::size_t number_of_words,
+        uint64_t& t_offset,
+        typename Mode::event* events,
+        std::size_t* number_of_discarded_events = nullptr) {
+        alignas(16) uint32_t ts[4];
+        alignas(16) uint32_t xs[4];
+        alignas(16) uint32_t ys[4];
+        alignas(16) uint32_t flags[4];
+        auto event = events;
+        std::size_t discarded_events = 0;
+        std::size_t index = 0;
+        for (; index + 4 <= number_of_words; index += 4) {
+            const auto words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * index));
+            const auto y = _mm_srli_epi32(words, 24);
+            const auto x = _mm_or_si128(
+                _mm_and_si128(_mm_srli_epi32(words, 16), _mm_set1_epi32(0xff)),
+                _mm_and_si128(_mm_srli_epi32(words, 5), _mm_set1_epi32(0x100)));
+            const auto lanes_are_in_range = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(
+                _mm_and_si128(_mm_cmplt_epi32(y, _mm_set1_epi32(240)), _mm_cmplt_epi32(x, _mm_set1_epi32(304))))));
+            const auto lanes_are_events = Mode::select(
+                lanes_are_in_range,
+                static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_slli_epi32(words, 17)))));
+            if (Mode::discards()) {
+                discarded_events +=
+                    static_cast<std::size_t>(__builtin_popcount(lanes_are_in_range & ~lanes_are_events));
+            }
+            const auto lanes_are_markers = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+                _mm_and_si128(words, _mm_set1_epi32(static_cast<int32_t>(0xffff3fff))),
+                _mm_set1_epi32(static_cast<int32_t>(0xf0313555))))));
+            if ((lanes_are_events | lanes_are_markers) == 0) {
+                continue;
+            }
+            _mm_store_si128(reinterpret_cast<__m128i*>(ts), _mm_and_si128(words, _mm_set1_epi32(0x1fff)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(xs), x);
+            _mm_store_si128(
+                reinterpret_cast<__m128i*>(ys), Mode::flips_y() ? _mm_sub_epi32(_mm_set1_epi32(239), y) : y);
+            _mm_store_si128(
+                reinterpret_cast<__m128i*>(flags), _mm_and_si128(_mm_srli_epi32(words, 14), _mm_set1_epi32(3)));
+            event = decode_lanes<4, Mode>(lanes_are_events, lanes_are_markers, ts, xs, ys, flags, t_offset, event);
+        }
+        if (number_of_discarded_events != nullptr) {
+            *number_of_discarded_events += discarded_events;
+        }
+        return static_cast<std::size_t>(event - events)
+               + decode_scalar<Mode>(
+                   data + 4 * index, number_of_words - index, t_offset, event, number_of_discarded_events);
+    }
+
+    /// decode_avx2 is an AVX2 implementation of decode_scalar, processing eight words at once.
+    template <typename Mode = atis_mode>
+    __attribute__((target("avx2"))) inline std::size_t decode_avx2(
+        const uint8_t* data,
+        std::size_t number_of_words,
+        uint64_t& t_offset,
+        typename Mode::event* events,
+        std::size_t* number_of_discarded_events = nullptr) {
+        alignas(32) uint32_t ts[8];
+        alignas(32) uint32_t xs[8];
+        alignas(32) uint32_t ys[8];
+        alignas(32) uint32_t flags[8];
+        auto event = events;
+        std::size_t discarded_events = 0;
+        std::size_t index = 0;
+        for (; index + 8 <= number_of_words; index += 8) {
+            const auto words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 4 * index));
+            const auto y = _mm256_srli_epi32(words, 24);
+            const auto x = _mm256_or_si256(
+                _mm256_and_si256(_mm256_srli_epi32(words, 16), _mm256_set1_epi32(0xff)),
+                _mm256_and_si256(_mm256_srli_epi32(words, 5), _mm256_set1_epi32(0x100)));
+            const auto lanes_are_in_range = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(
+                _mm256_and_si256(
+                    _mm256_cmpgt_epi32(_mm256_set1_epi32(240), y), _mm256_cmpgt_epi32(_mm256_set1_epi32(304), x)))));
+            const auto lanes_are_events = Mode::select(
+                lanes_are_in_range,
+                static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(words, 17)))));
+            if (Mode::discards()) {
+                discarded_events +=
+                    static_cast<std::size_t>(__builtin_popcount(lanes_are_in_range & ~lanes_are_events));
+            }
+            const auto lanes_are_markers = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(
+                _mm256_cmpeq_epi32(
+                    _mm256_and_si256(words, _mm256_set1_epi32(static_cast<int32_t>(0xffff3fff))),
+                    _mm256_set1_epi32(static_cast<int32_t>(0xf0313555))))));
+            if ((lanes_are_events | lanes_are_markers) == 0) {
+                continue;
+            }
+            _mm256_store_si256(reinterpret_cast<__m256i*>(ts), _mm256_and_si256(words, _mm256_set1_epi32(0x1fff)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(xs), x);
+            _mm256_store_si256(
+                reinterpret_cast<__m256i*>(ys), Mode::flips_y() ? _mm256_sub_epi32(_mm256_set1_epi32(239), y) : y);
+            _mm256_store_si256(
+                reinterpret_cast<__m256i*>(flags),
+                _mm256_and_si256(_mm256_srli_epi32(words, 14), _mm256_set1_epi32(3)));
+            event = decode_lanes<8, Mode>(lanes_are_events, lanes_are_markers, ts, xs, ys, flags, t_offset, event);
+        }
+        if (number_of_discarded_events != nullptr) {
+            *number_of_discarded_events += discarded_events;
+        }
+        return static_cast<std::size_t>(event - events)
+               + decode_scalar<Mode>(
+                   data + 4 * index, number_of_words - index, t_offset, event, number_of_discarded_events);
+    }
+#endif
+
+    /// decode converts pipe-out words to events with the given implementation.
+    /// The implementation must be supported by the processor (see best_instruction_set).
+    /// If number_of_discarded_events is not null, the events of a type discarded by the mode are added to it.
+    template <typename Mode = atis_mode>
+    inline std::size_t decode(
+        const uint8_t* data,
+        std::size_t number_of_words,
+        uint64_t& t_offset,
+        typename Mode::event* events,
+        instruction_set selected_instruction_set,
+        std::size_t* number_of_discarded_events = nullptr) {
+        switch (selected_instruction_set) {
+#ifdef OPAL_KELLY_ATIS_SEPIA_X86
+            case instruction_set::avx2:
+                return decode_avx2<Mode>(data, number_of_words, t_offset, events, number_of_discarded_events);
+            case instruction_set::sse2:
+                return decode_sse2<Mode>(data, number_of_words, t_offset, events, number_of_discarded_events);
+#endif
+            default:
+                return decode_scalar<Mode>(data, number_of_words, t_offset, events, number_of_discarded_events);
+        }
+    }
+
+    /// decode converts pipe-out words to events with the fastest supported implementation.
+    template <typename Mode = atis_mode>
+    inline std::size_t decode(
+        const uint8_t* data,
+        std::size_t number_of_words,
+        uint64_t& t_offset,
+        typename Mode::event* events,
+        std::size_t* number_of_discarded_events = nullptr) {
+        static const auto selected_instruction_set = best_instruction_set();
+        return decode<Mode>(
+            data, number_of_words, t_offset, events, selected_instruction_set, number_of_discarded_events);
+    }
+
+    /// scan counts the events that decode would write for pipe-out words, and the overflow markers among them.
+    /// It reads the words without writing events, so that a parallel decoder can place each chunk before decoding it.
+    template <typename Mode = atis_mode>
+    inline std::size_t scan(const uint8_t* data, std::size_t number_of_words, std::size_t& number_of_markers) {
+        std::size_t number_of_events = 0;
+        number_of_markers = 0;
+        for (std::size_t index = 0; index < number_of_words; ++index) {
+            const auto word = word_at(data + 4 * index);
+            if ((word >> 24) < 240) {
+                if ((((word >> 16) & 0xff) | ((word >> 5) & 0x100)) < 304 && Mode::keep(word >> 14)) {
+                    ++number_of_events;
+                }
+            } else if ((word & 0xffff3fff) == 0xf0313555) {
+                ++number_of_markers;
+            }
+        }
+        return number_of_events;
+    }
+
+    /// front_panel abstracts the Opal Kelly operations used to configure and read the ATIS.
+    class front_panel {
         public:
-        /// available_serials returns the connected Opal Kelly ATIS cameras' serials.
-        static std::vector<std::string> available_serials() {
-            OpalKellyLegacy::okCFrontPanel opal_kelly_front_panel;
-            std::vector<std::string> serials;
-            serials.reserve(opal_kelly_front_panel.GetDeviceCount());
-            for (auto device_index = 0; device_index < opal_kelly_front_panel.GetDeviceCount(); ++device_index) {
-                serials.push_back(opal_kelly_front_panel.GetDeviceListSerial(device_index));
+        front_panel() = default;
+        front_panel(const front_panel&) = delete;
+        front_panel(front_panel&&) = default;
+        front_panel& operator=(const front_panel&) = delete;
+        front_panel& operator=(front_panel&&) = default;
+        virtual ~front_panel() {}
+
+        /// serial returns the serial of the connected board.
+        /// The returned value differs from the original serial if the board was disconnected.
+        virtual std::string serial() = 0;
+
+        /// set_wire_in_value changes the bits of a wire-in selected by mask.
+        /// The change is sent to the board by the next call to update_wire_ins.
+        virtual void set_wire_in_value(int32_t address, uint32_t value, uint32_t mask = 0xffffffff) = 0;
+
+        /// update_wire_ins sends the wire-in values to the board.
+        virtual void update_wire_ins() = 0;
+
+        /// activate_trigger_in sends a trigger signal to the board.
+        virtual void activate_trigger_in(int32_t address, int32_t bit) = 0;
+
+        /// update_wire_outs retrieves the wire-out values from the board.
+        virtual void update_wire_outs() = 0;
+
+        /// wire_out_value returns a wire-out value retrieved by the last call to update_wire_outs.
+        virtual uint32_t wire_out_value(int32_t address) = 0;
+
+        /// read_from_pipe_out reads size bytes from a pipe-out.
+        virtual void read_from_pipe_out(int32_t address, std::size_t size, uint8_t* data) = 0;
+
+        /// read_from_block_pipe_out reads size bytes from a block pipe-out, in transfers of block_size bytes.
+        /// size must be a multiple of block_size. Front panels without block pipes read a regular pipe-out.
+        virtual void read_from_block_pipe_out(int32_t address, std::size_t, std::size_t size, uint8_t* data) {
+            read_from_pipe_out(address, size, data);
+        }
+    };
+
+    /// firmware_hash returns the 64-bit FNV-1a hash of a firmware file.
+    inline uint64_t firmware_hash(const std::string& firmware_filename) {
+        std::ifstream firmware_file(firmware_filename, std::ifstream::binary);
+        if (!firmware_file.good()) {
+            throw std::runtime_error("the firmware file '" + firmware_filename + "' does not exist or is not readable");
+        }
+        uint64_t hash = 0xcbf29ce484222325;
+        std::vector<char> buffer(1 << 16);
+        while (firmware_file) {
+            firmware_file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            for (auto iterator = buffer.begin(); iterator != buffer.begin() + firmware_file.gcount(); ++iterator) {
+                hash = (hash ^ static_cast<uint8_t>(*iterator)) * 0x100000001b3;
             }
-            return serials;
         }
+        return hash;
+    }
 
-        /// default_parameter returns the default parameter used by the Opal Kelly ATIS.
-        static std::unique_ptr<sepia::parameter> default_parameter() {
-            return sepia::make_unique<sepia::object_parameter>(
-                "firmware",
-                sepia::make_unique<sepia::string_parameter>(
-                    sepia::join({sepia::dirname(SEPIA_DIRNAME), "resources", "atis.1.1.1.bit"})),
-                "exposure_measurement_trigger",
-                sepia::make_unique<sepia::enum_parameter>(
-                    "change_detection",
-                    std::unordered_set<std::string>({
-                        "change_detection",
-                        "sequential",
-                        "manual",
-                    })),
-                "columns_selection",
-                sepia::array_parameter::make_empty(sepia::make_unique<sepia::number_parameter>(304, 1, 305, true)),
-                "select_first_column",
-                sepia::make_unique<sepia::boolean_parameter>(true),
-                "rows_selection",
-                sepia::array_parameter::make_empty(sepia::make_unique<sepia::number_parameter>(240, 1, 241, true)),
-                "select_first_row",
-                sepia::make_unique<sepia::boolean_parameter>(true),
-                "selection_is_region_of_interest",
-                sepia::make_unique<sepia::boolean_parameter>(false),
-                "send_fake_event_periodically",
-                sepia::make_unique<sepia::boolean_parameter>(false),
-                "apply_selection_to",
-                sepia::make_unique<sepia::enum_parameter>(
-                    "change_detection",
-                    std::unordered_set<std::string>({
-                        "change_detection",
-                        "exposure_measurement",
-                        "change_detection_and_exposure_measurement",
-                    })),
-                "change_detection",
-                sepia::make_unique<sepia::object_parameter>(
-                    "reset_switch_bulk_potential",
-                    sepia::make_unique<sepia::char_parameter>(207),
-                    "photoreceptor_feedback",
-                    sepia::make_unique<sepia::char_parameter>(216),
-                    "refractory_period",
-                    sepia::make_unique<sepia::char_parameter>(220),
-                    "follower",
-                    sepia::make_unique<sepia::char_parameter>(235),
-                    "event_source_amplifier",
-                    sepia::make_unique<sepia::char_parameter>(38),
-                    "on_event_threshold",
-                    sepia::make_unique<sepia::char_parameter>(48),
-                    "off_event_threshold",
-                    sepia::make_unique<sepia::char_parameter>(34),
-                    "off_event_inverter",
-                    sepia::make_unique<sepia::char_parameter>(61),
-                    "cascode_photoreceptor_feedback",
-                    sepia::make_unique<sepia::char_parameter>(154)),
-                "exposure_measurement",
-                sepia::make_unique<sepia::object_parameter>(
-                    "comparator_tail",
-                    sepia::make_unique<sepia::char_parameter>(40),
-                    "comparator_hysteresis",
-                    sepia::make_unique<sepia::char_parameter>(35),
-                    "comparator_output_stage",
-                    sepia::make_unique<sepia::char_parameter>(51),
-                    "upper_threshold",
-                    sepia::make_unique<sepia::char_parameter>(247),
-                    "lower_threshold",
-                    sepia::make_unique<sepia::char_parameter>(231)),
-                "pullup",
-                sepia::make_unique<sepia::object_parameter>(
-                    "exposure_measurement_abscissa_request",
-                    sepia::make_unique<sepia::char_parameter>(127),
-                    "exposure_measurement_ordinate_request",
-                    sepia::make_unique<sepia::char_parameter>(155),
-                    "change_detection_abscissa_request",
-                    sepia::make_unique<sepia::char_parameter>(151),
-                    "change_detection_ordinate_request",
-                    sepia::make_unique<sepia::char_parameter>(120),
-                    "abscissa_acknoledge",
-                    sepia::make_unique<sepia::char_parameter>(162),
-                    "abscissa_encoder",
-                    sepia::make_unique<sepia::char_parameter>(162),
-                    "ordinate_encoder",
-                    sepia::make_unique<sepia::char_parameter>(120)),
-                "control",
-                sepia::make_unique<sepia::object_parameter>(
-                    "exposure_measurement_timeout",
-                    sepia::make_unique<sepia::char_parameter>(42),
-                    "sequential_exposure_measurement_timeout",
-                    sepia::make_unique<sepia::char_parameter>(45),
-                    "abscissa_acknoledge_timeout",
-                    sepia::make_unique<sepia::char_parameter>(56),
-                    "latch_cell_scan_pulldown",
-                    sepia::make_unique<sepia::char_parameter>(134),
-                    "abscissa_request_pulldown",
-                    sepia::make_unique<sepia::char_parameter>(87)));
+    /// temporary_directory returns the directory given by TMPDIR, or /tmp if it is not set.
+    inline std::string temporary_directory() {
+        const auto directory = std::getenv("TMPDIR");
+        return directory == nullptr ? std::string("/tmp") : std::string(directory);
+    }
+
+    /// firmware_cache_filename returns the file storing the hash of the firmware last loaded on a board.
+    inline std::string firmware_cache_filename(const std::string& serial) {
+        return sepia::join({temporary_directory(), "opal_kelly_atis_sepia_" + serial + ".firmware"});
+    }
+
+    /// opal_kelly_front_panel implements front_panel with the Opal Kelly library.
+    /// If reuse_configured_firmware is true, the FPGA configuration is skipped when the board already runs the
+    /// firmware: FrontPanel must be enabled, and the firmware's hash must match the one cached when the board was
+    /// last configured. If version_wire_out is not zero, the value of this wire-out must also match version.
+    class opal_kelly_front_panel : public front_panel {
+        public:
+        opal_kelly_front_panel(
+            const std::string& serial,
+            const std::string& firmware_filename,
+            bool reuse_configured_firmware = false,
+            int32_t version_wire_out = 0,
+            uint32_t version = 0) :
+            _firmware_reused(false),
+            _firmware_duration(0) {
+            // open the connection to the ATIS
+            {
+                const auto serial_error = _opal_kelly_front_panel.OpenBySerial(serial);
+                if (serial_error != okCFrontPanel::NoError) {
+                    throw std::runtime_error(
+                        "connection to the serial '" + serial + "' raised the error " + std::to_string(serial_error));
+                }
+            }
+            const auto firmware_begin = std::chrono::steady_clock::now();
+
+            // the firmware is hashed only if it may be reused, since hashing reads the whole bitfile
+            const auto hash = reuse_configured_firmware ? firmware_hash(firmware_filename) : 0;
+
+            // check wether the board already runs the firmware
+            if (reuse_configured_firmware && _opal_kelly_front_panel.IsFrontPanelEnabled()) {
+                uint64_t cached_hash = 0;
+                std::ifstream cache_file(firmware_cache_filename(serial));
+                if (cache_file >> std::hex >> cached_hash && cached_hash == hash) {
+                    if (version_wire_out == 0) {
+                        _firmware_reused = true;
+                    } else {
+                        _opal_kelly_front_panel.UpdateWireOuts();
+                        _firmware_reused =
+                            static_cast<uint32_t>(_opal_kelly_front_panel.GetWireOutValue(version_wire_out)) == version;
+                    }
+                }
+            }
+
+            if (!_firmware_reused) {
+                // load the defaut PLL configuration
+                {
+                    const auto pll_error = _opal_kelly_front_panel.LoadDefaultPLLConfiguration();
+                    if (pll_error != okCFrontPanel::NoError) {
+                        throw std::runtime_error(
+                            "the default PLL configuration loading raised the error " + std::to_string(pll_error));
+                    }
+                }
+
+                // load the firmware
+                {
+                    const auto firmware_error = _opal_kelly_front_panel.ConfigureFPGA(firmware_filename);
+                    if (firmware_error != okCFrontPanel::NoError) {
+                        std::remove(firmware_cache_filename(serial).c_str());
+                        throw std::runtime_error(
+                            "the firmware loading from file '" + firmware_filename + "' raised the error "
+                            + std::to_string(firmware_error));
+                    }
+                }
+
+                // cache the firmware hash, so that the next camera can skip the configuration
+                // without reuse, the cache is removed instead, since it may describe a previous firmware
+                if (reuse_configured_firmware) {
+                    std::ofstream cache_file(firmware_cache_filename(serial));
+                    cache_file << std::hex << hash << std::endl;
+                } else {
+                    std::remove(firmware_cache_filename(serial).c_str());
+                }
+            }
+            _firmware_duration = std::chrono::steady_clock::now() - firmware_begin;
+        }
+        opal_kelly_front_panel(const opal_kelly_front_panel&) = delete;
+        opal_kelly_front_panel(opal_kelly_front_panel&&) = default;
+        opal_kelly_front_panel& operator=(const opal_kelly_front_panel&) = delete;
+        opal_kelly_front_panel& operator=(opal_kelly_front_panel&&) = default;
+        virtual ~opal_kelly_front_panel() {
+            if (_opal_kelly_front_panel.IsOpen()) {
+                _opal_kelly_front_panel.Close();
+            }
+        }
+        virtual std::string serial() override {
+            return _opal_kelly_front_panel.GetSerialNumber();
+        }
+        virtual void set_wire_in_value(int32_t address, uint32_t value, uint32_t mask = 0xffffffff) override {
+            _opal_kelly_front_panel.SetWireInValue(address, value, mask);
+        }
+        virtual void update_wire_ins() override {
+            _opal_kelly_front_panel.UpdateWireIns();
+        }
+        virtual void activate_trigger_in(int32_t address, int32_t bit) override {
+            _opal_kelly_front_panel.ActivateTriggerIn(address, bit);
+        }
+        virtual void update_wire_outs() override {
+            _opal_kelly_front_panel.UpdateWireOuts();
+        }
+        virtual uint32_t wire_out_value(int32_t address) override {
+            return static_cast<uint32_t>(_opal_kelly_front_panel.GetWireOutValue(address));
+        }
+        virtual void read_from_pipe_out(int32_t address, std::size_t size, uint8_t* data) override {
+            _opal_kelly_front_panel.ReadFromPipeOut(address, static_cast<long>(size), data);
+        }
+        virtual void read_from_block_pipe_out(int32_t address, std::size_t block_size, std::size_t size, uint8_t* data)
+            override {
+            _opal_kelly_front_panel.ReadFromBlockPipeOut(
+                address, static_cast<int>(block_size), static_cast<long>(size), data);
+        }
+
+        /// firmware_reused returns true if the FPGA configuration was skipped.
+        bool firmware_reused() const {
+            return _firmware_reused;
+        }
+
+        /// firmware_duration returns the time spent checking and loading the firmware.
+        std::chrono::nanoseconds firmware_duration() const {
+            return _firmware_duration;
+        }
+
+        protected:
+        OpalKellyLegacy::okCFrontPanel _opal_kelly_front_panel;
+        bool _firmware_reused;
+        std::chrono::nanoseconds _firmware_duration;
+    };
+
+    /// batched_front_panel decorates a front panel to reduce the number of wire-in round trips.
+    /// It keeps track of the wire-in values sent to the board, and skips the updates which do not change them.
+    /// If merge is true, updates are also deferred until the next operation which may depend on them (trigger-in,
+    /// wire-out or pipe-out), so that consecutive updates share one round trip. An update which changes bits
+    /// whose previous value was not sent yet flushes the pending update first, hence pulses are preserved.
+    /// Calls are serialised, so that the acquisition thread and the user thread can share the board.
+    class batched_front_panel : public front_panel {
+        public:
+        batched_front_panel(std::unique_ptr<front_panel> decorated_front_panel, bool merge) :
+            _front_panel(std::move(decorated_front_panel)),
+            _merge(merge),
+            _update_requested(false),
+            _wire_in_update_requests(0),
+            _wire_in_updates(0),
+            _trigger_ins(0) {
+            _values.fill(0);
+            _requested_values.fill(0);
+            _sent_values.fill(0);
+            _touched.fill(false);
+            _sent.fill(false);
+        }
+        batched_front_panel(const batched_front_panel&) = delete;
+        batched_front_panel(batched_front_panel&&) = delete;
+        batched_front_panel& operator=(const batched_front_panel&) = delete;
+        batched_front_panel& operator=(batched_front_panel&&) = delete;
+        virtual ~batched_front_panel() {}
+
+        virtual std::string serial() override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _front_panel->serial();
+        }
+        virtual void set_wire_in_value(int32_t address, uint32_t value, uint32_t mask = 0xffffffff) override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto& current_value = _values.at(static_cast<std::size_t>(address));
+            current_value = (current_value & ~mask) | (value & mask);
+            _touched[static_cast<std::size_t>(address)] = true;
+        }
+        virtual void update_wire_ins() override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            ++_wire_in_update_requests;
+            if (_merge && _update_requested) {
+                for (std::size_t address = 0; address < _values.size(); ++address) {
+                    const auto pending_bits =
+                        _sent[address] ? _requested_values[address] ^ _sent_values[address] : 0xffffffff;
+                    if ((pending_bits & (_values[address] ^ _requested_values[address])) != 0) {
+                        send();
+                        break;
+                    }
+                }
+            }
+            _requested_values = _values;
+            _update_requested = true;
+            if (!_merge) {
+                send();
+            }
+        }
+        virtual void activate_trigger_in(int32_t address, int32_t bit) override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            send();
+            ++_trigger_ins;
+            _front_panel->activate_trigger_in(address, bit);
+        }
+        virtual void update_wire_outs() override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            send();
+            _front_panel->update_wire_outs();
+        }
+        virtual uint32_t wire_out_value(int32_t address) override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _front_panel->wire_out_value(address);
+        }
+        virtual void read_from_pipe_out(int32_t address, std::size_t size, uint8_t* data) override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            send();
+            _front_panel->read_from_pipe_out(address, size, data);
+        }
+        virtual void read_from_block_pipe_out(int32_t address, std::size_t block_size, std::size_t size, uint8_t* data)
+            override {
+            std::lock_guard<std::mutex> lock(_mutex);
+            send();
+            _front_panel->read_from_block_pipe_out(address, block_size, size, data);
+        }
+
+        /// flush sends the pending wire-in update, if any.
+        void flush() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            send();
+        }
+
+        /// wire_in_update_requests returns the number of calls to update_wire_ins.
+        std::size_t wire_in_update_requests() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _wire_in_update_requests;
+        }
+
+        /// wire_in_updates returns the number of wire-in updates sent to the board.
+        std::size_t wire_in_updates() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _wire_in_updates;
+        }
+
+        /// trigger_ins returns the number of trigger signals sent to the board.
+        std::size_t trigger_ins() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _trigger_ins;
+        }
+
+        protected:
+        /// send forwards the requested wire-in values which differ from the board's.
+        /// It must be called with the mutex locked.
+        void send() {
+            if (!_update_requested) {
+                return;
+            }
+            _update_requested = false;
+            auto changed = false;
+            for (std::size_t address = 0; address < _values.size(); ++address) {
+                if (_touched[address] && (!_sent[address] || _requested_values[address] != _sent_values[address])) {
+                    _front_panel->set_wire_in_value(static_cast<int32_t>(address), _requested_values[address]);
+                    _sent_values[address] = _requested_values[address];
+                    _sent[address] = true;
+                    changed = true;
+                }
+            }
+            if (changed) {
+                ++_wire_in_updates;
+                _front_panel->update_wire_ins();
+            }
+        }
+
+        std::unique_ptr<front_panel> _front_panel;
+        const bool _merge;
+        std::array<uint32_t, 32> _values;
+        std::array<uint32_t, 32> _requested_values;
+        std::array<uint32_t, 32> _sent_values;
+        std::array<bool, 32> _touched;
+        std::array<bool, 32> _sent;
+        bool _update_requested;
+        std::size_t _wire_in_update_requests;
+        std::size_t _wire_in_updates;
+        std::size_t _trigger_ins;
+        std::mutex _mutex;
+    };
+
+    /// replay_front_panel implements front_panel with recorded or synthetic words, without hardware.
+    /// The words are served as fast as possible, or at the pace given by their timestamps (in microseconds).
+    /// If bytes_per_second is positive, reads take as long as they would on a link with this bandwidth.
+    /// Configuration writes are accepted and ignored.
+    class replay_front_panel : public front_panel {
+        public:
+        /// pacing lists the replay speeds.
+        enum class pacing {
+            as_fast_as_possible,
+            real_time,
+        };
+
+        replay_front_panel(
+            std::vector<uint8_t> data,
+            pacing selected_pacing,
+            std::size_t maximum_words_per_poll = 1 << 24,
+            std::string serial = "replay",
+            double bytes_per_second = 0) :
+            _data(std::move(data)),
+            _pacing(selected_pacing),
+            _maximum_words_per_poll(
+                std::max(maximum_words_per_poll & ~static_cast<std::size_t>(0x1f), static_cast<std::size_t>(32))),
+            _serial(std::move(serial)),
+            _bytes_per_second(bytes_per_second),
+            _offset(0),
+            _available_words(0),
+            _started(false),
+            _scan_index(0),
+            _scan_t_offset(0) {
+            // the board reports multiples of 32 words, hence the data is padded with out-of-range words
+            _data.resize(_data.size() / 4 * 4);
+            while (_data.size() % 128 != 0) {
+                _data.push_back(0xff);
+            }
+        }
+        replay_front_panel(const replay_front_panel&) = delete;
+        replay_front_panel(replay_front_panel&&) = delete;
+        replay_front_panel& operator=(const replay_front_panel&) = delete;
+        replay_front_panel& operator=(replay_front_panel&&) = delete;
+        virtual ~replay_front_panel() {}
+
+        /// exhausted returns true once all the words were read.
+        /// It can be called from any thread.
+        bool exhausted() const {
+            return _offset.load(std::memory_order_acquire) == _data.size();
+        }
+
+        virtual std::string serial() override {
+            return _serial;
+        }
+        virtual void set_wire_in_value(int32_t, uint32_t, uint32_t) override {}
+        virtual void update_wire_ins() override {}
+        virtual void activate_trigger_in(int32_t, int32_t) override {}
+        virtual void update_wire_outs() override {
+            const auto number_of_words = _data.size() / 4;
+            auto end = number_of_words;
+            if (_pacing == pacing::real_time) {
+                const auto now = std::chrono::steady_clock::now();
+                if (!_started) {
+                    _started = true;
+                    _time_reference = now;
+                }
+                const auto elapsed = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(now - _time_reference).count());
+                for (; _scan_index < number_of_words; ++_scan_index) {
+                    const auto word = word_at(_data.data() + 4 * _scan_index);
+                    if ((word & 0xffff3fff) == 0xf0313555) {
+                        _scan_t_offset += 0x2000;
+                    } else if ((word >> 24) < 240 && _scan_t_offset + (word & 0x1fff) > elapsed) {
+                        break;
+                    }
+                }
+                end = _scan_index & ~static_cast<std::size_t>(0x1f);
+            }
+            _available_words =
+                std::min(end - _offset.load(std::memory_order_relaxed) / 4, _maximum_words_per_poll);
+        }
+        virtual uint32_t wire_out_value(int32_t address) override {
+            return static_cast<uint32_t>(
+                address == 0x20 ? ((_available_words >> 5) & 0xffff) : (address == 0x21 ? _available_words >> 21 : 0));
+        }
+        virtual void read_from_pipe_out(int32_t, std::size_t size, uint8_t* data) override {
+            const auto offset = _offset.load(std::memory_order_relaxed);
+            size = std::min(size, _data.size() - offset);
+            if (_bytes_per_second > 0) {
+                // the link time accumulates, so that the sleeps' overshoots do not lower the bandwidth
+                _link_time = std::max(_link_time, std::chrono::steady_clock::now())
+                             + std::chrono::nanoseconds(static_cast<int64_t>(size * 1e9 / _bytes_per_second));
+                std::this_thread::sleep_until(_link_time);
+            }
+            std::copy(_data.begin() + offset, _data.begin() + offset + size, data);
+            _offset.store(offset + size, std::memory_order_release);
+        }
+
+        protected:
+        std::vector<uint8_t> _data;
+        const pacing _pacing;
+        const std::size_t _maximum_words_per_poll;
+        const std::string _serial;
+        const double _bytes_per_second;
+        std::chrono::steady_clock::time_point _link_time;
+        std::atomic<std::size_t> _offset;
+        std::size_t _available_words;
+        bool _started;
+        std::chrono::steady_clock::time_point _time_reference;
+        std::size_t _scan_index;
+        uint64_t _scan_t_offset;
+    };
+
+    /// make_replay_front_panel creates a replay front panel from a file written by a raw camera.
+    inline std::unique_ptr<replay_front_panel> make_replay_front_panel(
+        const std::string& raw_filename,
+        replay_front_panel::pacing selected_pacing,
+        std::size_t maximum_words_per_poll = 1 << 24) {
+        auto raw_stream = sepia::filename_to_ifstream(raw_filename);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(*raw_stream)), std::istreambuf_iterator<char>());
+        return sepia::make_unique<replay_front_panel>(std::move(data), selected_pacing, maximum_words_per_poll);
+    }
+
+    /// aligned_buffer is an uninitialised byte buffer aligned on memory pages, as required by direct input/output.
+    /// Since the buffer is not initialised, its pages become resident only once they are written.
+    /// If huge_pages is true, the buffer is aligned on huge pages and the kernel is advised to back it with them
+    /// (transparent huge pages on Linux), which reduces TLB misses on large buffers.
+    class aligned_buffer {
+        public:
+        /// alignment is the address and size granularity of direct input/output.
+        static constexpr std::size_t alignment = 1 << 12;
+
+        /// huge_page_alignment is the alignment of buffers backed by huge pages.
+        static constexpr std::size_t huge_page_alignment = 1 << 21;
+
+        aligned_buffer(std::size_t size, bool huge_pages = false) : _data(nullptr), _size(size) {
+            const auto selected_alignment = huge_pages && size >= huge_page_alignment ? huge_page_alignment : alignment;
+            const auto allocated_size = (std::max(size, alignment) + selected_alignment - 1) / selected_alignment
+                                        * selected_alignment;
+            void* data = nullptr;
+            if (posix_memalign(&data, selected_alignment, allocated_size) != 0) {
+                throw std::bad_alloc();
+            }
+            _data = static_cast<uint8_t*>(data);
+#ifdef MADV_HUGEPAGE
+            if (selected_alignment == huge_page_alignment) {
+                madvise(_data, allocated_size, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        aligned_buffer(const aligned_buffer&) = delete;
+        aligned_buffer(aligned_buffer&& other) : _data(other._data), _size(other._size) {
+            other._data = nullptr;
+            other._size = 0;
+        }
+        aligned_buffer& operator=(const aligned_buffer&) = delete;
+        aligned_buffer& operator=(aligned_buffer&& other) {
+            std::swap(_data, other._data);
+            std::swap(_size, other._size);
+            return *this;
+        }
+        virtual ~aligned_buffer() {
+            std::free(_data);
+        }
+
+        /// data returns a pointer to the first byte.
+        uint8_t* data() const {
+            return _data;
+        }
+
+        /// size returns the number of bytes.
+        std::size_t size() const {
+            return _size;
+        }
+
+        /// resident_size returns the number of bytes backed by physical memory, rounded to pages.
+        std::size_t resident_size() const {
+            if (_size == 0) {
+                return 0;
+            }
+            const auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            const auto number_of_pages = (_size + page_size - 1) / page_size;
+#ifdef __APPLE__
+            std::vector<char> pages(number_of_pages);
+#else
+            std::vector<unsigned char> pages(number_of_pages);
+#endif
+            if (mincore(_data, _size, pages.data()) != 0) {
+                return _size;
+            }
+            std::size_t number_of_resident_pages = 0;
+            for (const auto page : pages) {
+                number_of_resident_pages += page & 1;
+            }
+            return std::min(number_of_resident_pages * page_size, _size);
+        }
+
+        protected:
+        uint8_t* _data;
+        std::size_t _size;
+    };
+
+    /// memory_statistics reports the host memory used by a camera's buffers, in bytes.
+    /// The buffers are not initialised, hence allocated memory is mostly address space: a page becomes resident
+    /// once a read or an event touches it, so that resident memory follows the actual read sizes and FIFO occupancy.
+    ///     - read_buffers: pipe-out words, read by the acquisition thread or passed between the pipelined threads
+    ///     - fifo: decoded events waiting for the handler
+    struct memory_statistics {
+        uint64_t allocated_read_buffers_bytes;
+        uint64_t resident_read_buffers_bytes;
+        uint64_t allocated_fifo_bytes;
+        uint64_t resident_fifo_bytes;
+    };
+
+    /// thread_role lists the acquisition threads which can be placed.
+    ///     - reading: polls the board and reads the pipe-out (and decodes unless the acquisition is pipelined or
+    ///       streaming)
+    ///     - decoding: decodes the words of a pipelined or streaming acquisition
+    ///     - dispatching: calls the events handler
+    enum class thread_role {
+        reading,
+        decoding,
+        dispatching,
+    };
+
+    /// thread_placement describes the placement applied to a thread.
+    ///     - cpu: the core the thread is pinned to, or -1 if it may run on any core
+    ///     - real_time: true if the thread runs with a real-time scheduling policy (SCHED_FIFO or SCHED_RR)
+    struct thread_placement {
+        int cpu;
+        bool real_time;
+    };
+
+    /// placement_report lists the placements applied to a camera's threads.
+    /// A thread which does not exist (the decoding thread of a non-pipelined acquisition, for instance) is reported
+    /// as not placed.
+    struct placement_report {
+        thread_placement reading;
+        thread_placement decoding;
+        thread_placement dispatching;
+    };
+
+    /// place_current_thread pins the calling thread to a core (unless cpu is negative), and requests a real-time
+    /// scheduling policy ("fifo" or "round_robin") with the given priority (unless policy is "default").
+    /// Each request is applied only if the system allows it (real-time policies usually require CAP_SYS_NICE),
+    /// and the placement actually applied is returned. Placement is only supported on Linux.
+    inline thread_placement place_current_thread(int cpu, const std::string& policy, int priority) {
+        thread_placement placement{-1, false};
+#ifdef __linux__
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(cpu, &cpus);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpus) == 0) {
+                placement.cpu = cpu;
+            }
+        }
+        if (policy != "default") {
+            sched_param parameter;
+            parameter.sched_priority = priority;
+            if (pthread_setschedparam(pthread_self(), policy == "fifo" ? SCHED_FIFO : SCHED_RR, &parameter) == 0) {
+                placement.real_time = true;
+            }
+        }
+#else
+        (void)cpu;
+        (void)policy;
+        (void)priority;
+#endif
+        return placement;
+    }
+
+    /// raw_writer appends pipe-out words to a file with large aligned writes.
+    /// If direct is true, the writes bypass the operating system cache (O_DIRECT on Linux, F_NOCACHE on macOS).
+    /// If asynchronous is true, full blocks are written by a dedicated thread, so that the caller only copies data.
+    class raw_writer {
+        public:
+        raw_writer(
+            const std::string& filename,
+            bool direct,
+            bool asynchronous,
+            std::size_t block_size,
+            std::size_t number_of_blocks) :
+            _direct(direct),
+            _asynchronous(asynchronous),
+            _file_descriptor(-1),
+            _fill(0),
+            _write_index(0),
+            _read_index(0),
+            _number_of_filled_blocks(0),
+            _running(true) {
+            block_size = (block_size + aligned_buffer::alignment - 1) / aligned_buffer::alignment
+                         * aligned_buffer::alignment;
+            const auto blocks = asynchronous ? std::max(number_of_blocks, static_cast<std::size_t>(2)) : 1;
+            for (std::size_t index = 0; index < blocks; ++index) {
+                _blocks.emplace_back(block_size);
+            }
+#ifdef O_DIRECT
+            _file_descriptor = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | (_direct ? O_DIRECT : 0), 0644);
+            if (_file_descriptor < 0 && _direct && errno == EINVAL) {
+                // the file system does not support direct input/output
+                _direct = false;
+                _file_descriptor = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            }
+#else
+            _file_descriptor = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#ifdef F_NOCACHE
+            if (_file_descriptor >= 0 && _direct) {
+                fcntl(_file_descriptor, F_NOCACHE, 1);
+            }
+#endif
+#endif
+            if (_file_descriptor < 0) {
+                throw std::runtime_error(
+                    "the raw file '" + filename + "' could not be opened for writing (" + std::strerror(errno) + ")");
+            }
+            if (_asynchronous) {
+                _writing_loop = std::thread([this]() -> void {
+                    try {
+                        for (;;) {
+                            {
+                                std::unique_lock<std::mutex> lock(_mutex);
+                                _condition_variable.wait(
+                                    lock, [this] { return _number_of_filled_blocks > 0 || !_running; });
+                                if (_number_of_filled_blocks == 0) {
+                                    break;
+                                }
+                            }
+                            write_all(_blocks[_read_index].data(), _blocks[_read_index].size());
+                            std::unique_lock<std::mutex> lock(_mutex);
+                            _read_index = (_read_index + 1) % _blocks.size();
+                            --_number_of_filled_blocks;
+                            _condition_variable.notify_all();
+                        }
+                    } catch (...) {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        _exception = std::current_exception();
+                        _running = false;
+                        _number_of_filled_blocks = 0;
+                        _condition_variable.notify_all();
+                    }
+                });
+            }
+        }
+        raw_writer(const raw_writer&) = delete;
+        raw_writer(raw_writer&&) = delete;
+        raw_writer& operator=(const raw_writer&) = delete;
+        raw_writer& operator=(raw_writer&&) = delete;
+        virtual ~raw_writer() {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+
+        /// write appends size bytes to the file.
+        void write(const uint8_t* data, std::size_t size) {
+            while (size > 0) {
+                auto& block = _blocks[_write_index];
+                const auto copied_size = std::min(size, block.size() - _fill);
+                std::copy(data, data + copied_size, block.data() + _fill);
+                _fill += copied_size;
+                data += copied_size;
+                size -= copied_size;
+                if (_fill == block.size()) {
+                    if (_asynchronous) {
+                        std::unique_lock<std::mutex> lock(_mutex);
+                        if (_exception) {
+                            std::rethrow_exception(_exception);
+                        }
+                        ++_number_of_filled_blocks;
+                        _write_index = (_write_index + 1) % _blocks.size();
+                        _condition_variable.notify_all();
+                        _condition_variable.wait(
+                            lock, [this] { return _number_of_filled_blocks < _blocks.size() || !_running; });
+                        if (_exception) {
+                            std::rethrow_exception(_exception);
+                        }
+                    } else {
+                        write_all(block.data(), block.size());
+                    }
+                    _fill = 0;
+                }
+            }
+        }
+
+        /// close writes the pending data and closes the file.
+        void close() {
+            if (_file_descriptor < 0) {
+                return;
+            }
+            if (_asynchronous) {
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _running = false;
+                    _condition_variable.notify_all();
+                }
+                _writing_loop.join();
+            }
+            if (!_exception && _fill > 0) {
+                try {
+#ifdef O_DIRECT
+                    // the last block is not a multiple of the alignment, and must bypass direct input/output
+                    if (_direct) {
+                        fcntl(_file_descriptor, F_SETFL, fcntl(_file_descriptor, F_GETFL) & ~O_DIRECT);
+                    }
+#endif
+                    write_all(_blocks[_write_index].data(), _fill);
+                    _fill = 0;
+                } catch (...) {
+                    _exception = std::current_exception();
+                }
+            }
+            const auto close_result = ::close(_file_descriptor);
+            _file_descriptor = -1;
+            if (_exception) {
+                std::rethrow_exception(_exception);
+            }
+            if (close_result < 0) {
+                throw std::runtime_error(std::string("closing the raw file failed (") + std::strerror(errno) + ")");
+            }
+        }
+
+        protected:
+        /// write_all writes size bytes to the file, retrying partial writes.
+        void write_all(const uint8_t* data, std::size_t size) {
+            while (size > 0) {
+                const auto written_size = ::write(_file_descriptor, data, size);
+                if (written_size < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    throw std::runtime_error(std::string("writing the raw file failed (") + std::strerror(errno) + ")");
+                }
+                data += written_size;
+                size -= static_cast<std::size_t>(written_size);
+            }
+        }
+
+        bool _direct;
+        const bool _asynchronous;
+        int _file_descriptor;
+        std::vector<aligned_buffer> _blocks;
+        std::size_t _fill;
+        std::size_t _write_index;
+        std::size_t _read_index;
+        std::size_t _number_of_filled_blocks;
+        bool _running;
+        std::exception_ptr _exception;
+        std::mutex _mutex;
+        std::condition_variable _condition_variable;
+        std::thread _writing_loop;
+    };
+
+    /// overflow_policy lists the behaviours when the host FIFO is full, or when the board's FIFO overflowed.
+    ///     - fail: the acquisition stops with an exception
+    ///     - drop_newest: the words which do not fit in the host FIFO are dropped
+    ///     - drop_oldest: the dispatching thread discards the oldest events until the FIFO is half full
+    ///     - drop_threshold_crossings: threshold crossings are dropped while the FIFO is more than half full, then the
+    ///       newest events are dropped if it is full
+    ///     - back_pressure: the decoding thread waits for the handler, and the words accumulate on the board
+    ///     - spill: the words which do not fit are stored in a memory-mapped file, and decoded once the handler
+    ///       catches up
+    /// The policies other than fail also keep the acquisition running after a board overflow.
+    enum class overflow_policy {
+        fail,
+        drop_newest,
+        drop_oldest,
+        drop_threshold_crossings,
+        back_pressure,
+        spill,
+    };
+
+    /// events_dropped is passed to the drop handler (see camera::set_drop_handler) when an overflow policy drops
+    /// events. It does not stop the acquisition, and is reported once per overflow episode, that is for the first
+    /// dropping read after a read which did not drop anything. The statistics count the dropped events.
+    class events_dropped : public std::runtime_error {
+        public:
+        events_dropped(const std::string& what) : std::runtime_error(what) {}
+    };
+
+    /// spill_ring is a circular buffer of pipe-out words backed by a memory-mapped file.
+    /// It stores the words which do not fit in the host FIFO, so that they can be decoded in order later.
+    /// An empty filename creates a temporary file, which is removed as soon as it is mapped.
+    class spill_ring {
+        public:
+        spill_ring(std::string filename, std::size_t number_of_words) :
+            _data(nullptr),
+            _capacity(number_of_words),
+            _head(0),
+            _size(0) {
+            int file_descriptor = -1;
+            if (filename.empty()) {
+                const auto pattern = sepia::join({temporary_directory(), "opal_kelly_atis_sepia_spill_XXXXXX"});
+                std::vector<char> temporary_filename(pattern.begin(), pattern.end());
+                temporary_filename.push_back('\0');
+                file_descriptor = mkstemp(temporary_filename.data());
+                filename = temporary_filename.data();
+                if (file_descriptor >= 0) {
+                    unlink(temporary_filename.data());
+                }
+            } else {
+                file_descriptor = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            }
+            if (file_descriptor < 0) {
+                throw std::runtime_error(
+                    "the spill file '" + filename + "' could not be opened (" + std::strerror(errno) + ")");
+            }
+            if (ftruncate(file_descriptor, static_cast<off_t>(_capacity * 4)) != 0) {
+                const auto error = errno;
+                close(file_descriptor);
+                throw std::runtime_error(
+                    "the spill file '" + filename + "' could not be resized (" + std::strerror(error) + ")");
+            }
+            auto data = mmap(nullptr, _capacity * 4, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+            const auto error = errno;
+            close(file_descriptor);
+            if (data == MAP_FAILED) {
+                throw std::runtime_error(
+                    "the spill file '" + filename + "' could not be mapped (" + std::strerror(error) + ")");
+            }
+            _data = static_cast<uint8_t*>(data);
+        }
+        spill_ring(const spill_ring&) = delete;
+        spill_ring(spill_ring&&) = delete;
+        spill_ring& operator=(const spill_ring&) = delete;
+        spill_ring& operator=(spill_ring&&) = delete;
+        virtual ~spill_ring() {
+            munmap(_data, _capacity * 4);
+        }
+
+        /// size returns the number of stored words.
+        std::size_t size() const {
+            return _size;
+        }
+
+        /// push appends words to the ring.
+        /// If the words do not fit, false is returned and nothing is stored.
+        bool push(const uint8_t* data, std::size_t number_of_words) {
+            if (_capacity - _size < number_of_words) {
+                return false;
+            }
+            const auto tail = (_head + _size) % _capacity;
+            const auto first_size = std::min(number_of_words, _capacity - tail);
+            std::copy(data, data + first_size * 4, _data + tail * 4);
+            std::copy(data + first_size * 4, data + number_of_words * 4, _data);
+            _size += number_of_words;
+            return true;
+        }
+
+        /// readable returns the contiguous stored words after the last released word.
+        const uint8_t* readable(std::size_t& number_of_words) const {
+            number_of_words = std::min(_size, _capacity - _head);
+            return _data + _head * 4;
+        }
+
+        /// release frees the first number_of_words words returned by readable.
+        void release(std::size_t number_of_words) {
+            _head = (_head + number_of_words) % _capacity;
+            _size -= number_of_words;
+        }
+
+        protected:
+        uint8_t* _data;
+        const std::size_t _capacity;
+        std::size_t _head;
+        std::size_t _size;
+    };
+
+    /// polling_scheduler decides how long the acquisition loop waits before polling the board's FIFO again.
+    /// The fixed policy waits for a constant duration after every empty poll.
+    /// The adaptive policy estimates the event rate from the FIFO fill levels, and waits until a batch of words
+    /// is likely available, backing off exponentially while the FIFO stays empty. The wait never exceeds
+    /// the latency target, and the polling overhead is kept below the given fraction of a core.
+    /// Waits always sleep, hence the timer slack (typically tens of microseconds) adds to the latency target.
+    class polling_scheduler {
+        public:
+        /// batch_words is the number of words that the adaptive policy waits for before reading.
+        static constexpr std::size_t batch_words = 1 << 12;
+
+        polling_scheduler(
+            bool adaptive,
+            std::chrono::microseconds sleep_duration,
+            std::chrono::microseconds latency_target,
+            double cpu_budget) :
+            _adaptive(adaptive),
+            _sleep_duration(sleep_duration),
+            _latency_target(latency_target),
+            _cpu_budget(cpu_budget),
+            _wait_duration(0),
+            _poll_duration(0),
+            _words_per_second(0),
+            _maximum_wait(std::chrono::microseconds::max()),
+            _previous_poll(std::chrono::steady_clock::now()),
+            _poll_interval(0) {}
+        polling_scheduler(const polling_scheduler&) = delete;
+        polling_scheduler(polling_scheduler&&) = delete;
+        polling_scheduler& operator=(const polling_scheduler&) = delete;
+        polling_scheduler& operator=(polling_scheduler&&) = delete;
+        virtual ~polling_scheduler() {}
+
+        /// wait blocks the acquisition loop after a poll.
+        /// number_of_words is the FIFO fill level returned by the poll, and poll_duration its round-trip time.
+        void wait(std::size_t number_of_words, std::chrono::nanoseconds poll_duration) {
+            const auto now = std::chrono::steady_clock::now();
+            const auto poll_interval =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - _previous_poll).count();
+            _previous_poll = now;
+            _poll_interval.store(
+                (_poll_interval.load(std::memory_order_relaxed) * 7 + static_cast<uint64_t>(poll_interval)) / 8,
+                std::memory_order_relaxed);
+            if (!_adaptive) {
+                if (number_of_words == 0) {
+                    std::this_thread::sleep_for(std::min(_sleep_duration, _maximum_wait));
+                }
+                return;
+            }
+            _poll_duration = (_poll_duration * 7 + static_cast<double>(poll_duration.count())) / 8;
+            if (poll_interval > 0) {
+                _words_per_second = (_words_per_second * 7 + number_of_words * 1e9 / poll_interval) / 8;
+            }
+            if (number_of_words >= batch_words) {
+                _wait_duration = 0;
+                return;
+            }
+            const auto latency_target = static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(_latency_target).count());
+            if (number_of_words > 0 && _words_per_second > 0) {
+                _wait_duration = std::min(batch_words * 1e9 / _words_per_second, latency_target);
+            } else {
+                _wait_duration = std::min(std::max(_wait_duration * 2, 1e4), latency_target);
+            }
+            _wait_duration = std::max(_wait_duration, _poll_duration * (1 - _cpu_budget) / _cpu_budget);
+            _wait_duration =
+                std::min(_wait_duration, std::chrono::duration<double, std::nano>(_maximum_wait).count());
+            // waits always sleep, since spinning would use a whole core regardless of the CPU budget
+            std::this_thread::sleep_until(now + std::chrono::nanoseconds(static_cast<int64_t>(_wait_duration)));
+        }
+
+        /// limit_wait caps the waits of both policies, ahead of the CPU budget.
+        /// It must be called before the acquisition starts.
+        void limit_wait(std::chrono::microseconds maximum_wait) {
+            _maximum_wait = maximum_wait;
+        }
+
+        /// poll_rate returns the number of polls per second, averaged over the last polls.
+        /// It can be called from any thread.
+        double poll_rate() const {
+            const auto poll_interval = _poll_interval.load(std::memory_order_relaxed);
+            return poll_interval == 0 ? 0.0 : 1e9 / poll_interval;
+        }
+
+        protected:
+        const bool _adaptive;
+        const std::chrono::microseconds _sleep_duration;
+        const std::chrono::microseconds _latency_target;
+        const double _cpu_budget;
+        double _wait_duration;
+        double _poll_duration;
+        double _words_per_second;
+        std::chrono::microseconds _maximum_wait;
+        std::chrono::steady_clock::time_point _previous_poll;
+        std::atomic<uint64_t> _poll_interval;
+    };
+
+    /// transfer_ring passes preallocated pipe-out buffers from a reading thread to a decoding thread.
+    /// The buffers are not initialised, so that only the pages touched by reads become resident.
+    class transfer_ring {
+        public:
+        transfer_ring(std::size_t number_of_buffers, std::size_t words_per_buffer, bool huge_pages = false) :
+            _words_per_buffer(words_per_buffer),
+            _numbers_of_words(number_of_buffers, 0),
+            _read_times(number_of_buffers),
+            _write_index(0),
+            _read_index(0),
+            _number_of_filled_buffers(0),
+            _closed(false) {
+            _buffers.reserve(number_of_buffers);
+            for (std::size_t index = 0; index < number_of_buffers; ++index) {
+                _buffers.emplace_back(words_per_buffer * 4, huge_pages);
+            }
+        }
+        transfer_ring(const transfer_ring&) = delete;
+        transfer_ring(transfer_ring&&) = delete;
+        transfer_ring& operator=(const transfer_ring&) = delete;
+        transfer_ring& operator=(transfer_ring&&) = delete;
+        virtual ~transfer_ring() {}
+
+        /// words_per_buffer returns the capacity of each buffer, in words.
+        std::size_t words_per_buffer() const {
+            return _words_per_buffer;
+        }
+
+        /// allocated_size returns the number of bytes allocated for the buffers.
+        std::size_t allocated_size() const {
+            return _buffers.size() * _words_per_buffer * 4;
+        }
+
+        /// resident_size returns the number of bytes of the buffers backed by physical memory.
+        std::size_t resident_size() const {
+            std::size_t size = 0;
+            for (const auto& buffer : _buffers) {
+                size += buffer.resident_size();
+            }
+            return size;
+        }
+
+        /// writable waits for an empty buffer and returns it.
+        /// nullptr is returned if the ring was closed.
+        uint8_t* writable() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition_variable.wait(lock, [this] { return _closed || _number_of_filled_buffers < _buffers.size(); });
+            return _closed ? nullptr : _buffers[_write_index].data();
+        }
+
+        /// commit hands the buffer returned by writable to the decoding thread.
+        /// read_time is the host time at which the words were read from the pipe-out.
+        void commit(std::size_t number_of_words, std::chrono::steady_clock::time_point read_time) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _numbers_of_words[_write_index] = number_of_words;
+            _read_times[_write_index] = read_time;
+            _write_index = (_write_index + 1) % _buffers.size();
+            ++_number_of_filled_buffers;
+            _condition_variable.notify_all();
+        }
+
+        /// readable waits for a filled buffer and returns it.
+        /// The buffers filled before the ring was closed are still returned, then nullptr is returned.
+        const uint8_t* readable(std::size_t& number_of_words, std::chrono::steady_clock::time_point& read_time) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition_variable.wait(lock, [this] { return _closed || _number_of_filled_buffers > 0; });
+            if (_number_of_filled_buffers == 0) {
+                return nullptr;
+            }
+            number_of_words = _numbers_of_words[_read_index];
+            read_time = _read_times[_read_index];
+            return _buffers[_read_index].data();
+        }
+
+        /// release hands the buffer returned by readable back to the reading thread.
+        void release() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _read_index = (_read_index + 1) % _buffers.size();
+            --_number_of_filled_buffers;
+            _condition_variable.notify_all();
+        }
+
+        /// close wakes up both threads, makes subsequent calls to writable return nullptr,
+        /// and makes readable return nullptr once the filled buffers are consumed.
+        void close() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _closed = true;
+            _condition_variable.notify_all();
+        }
+
+        protected:
+        const std::size_t _words_per_buffer;
+        std::vector<aligned_buffer> _buffers;
+        std::vector<std::size_t> _numbers_of_words;
+        std::vector<std::chrono::steady_clock::time_point> _read_times;
+        std::size_t _write_index;
+        std::size_t _read_index;
+        std::size_t _number_of_filled_buffers;
+        bool _closed;
+        std::mutex _mutex;
+        std::condition_variable _condition_variable;
+    };
+
+    /// decoding_pool runs the chunks of a parallel decode on worker threads.
+    /// The thread calling run decodes chunks as well, hence a pool of n threads starts n - 1 workers.
+    class decoding_pool {
+        public:
+        decoding_pool(std::size_t number_of_threads) :
+            _running(true),
+            _generation(0),
+            _number_of_tasks(0),
+            _next_task(0),
+            _pending_tasks(0) {
+            for (std::size_t index = 1; index < number_of_threads; ++index) {
+                _workers.emplace_back([this]() {
+                    uint64_t generation = 0;
+                    for (;;) {
+                        {
+                            std::unique_lock<std::mutex> lock(_mutex);
+                            _tasks_available.wait(lock, [&] { return !_running || _generation != generation; });
+                            if (!_running) {
+                                return;
+                            }
+                            generation = _generation;
+                        }
+                        work();
+                    }
+                });
+            }
+        }
+        decoding_pool(const decoding_pool&) = delete;
+        decoding_pool(decoding_pool&&) = delete;
+        decoding_pool& operator=(const decoding_pool&) = delete;
+        decoding_pool& operator=(decoding_pool&&) = delete;
+        virtual ~decoding_pool() {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _running = false;
+            }
+            _tasks_available.notify_all();
+            for (auto& worker : _workers) {
+                worker.join();
+            }
+        }
+
+        /// size returns the number of threads decoding chunks, including the calling thread.
+        std::size_t size() const {
+            return _workers.size() + 1;
+        }
+
+        /// run calls task with every index in [0, number_of_tasks), and returns once all the calls have returned.
+        /// task must not throw.
+        void run(std::size_t number_of_tasks, const std::function<void(std::size_t)>& task) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _task = &task;
+                _number_of_tasks = number_of_tasks;
+                _next_task = 0;
+                _pending_tasks = number_of_tasks;
+                ++_generation;
+            }
+            _tasks_available.notify_all();
+            work();
+            std::unique_lock<std::mutex> lock(_mutex);
+            _tasks_done.wait(lock, [this] { return _pending_tasks == 0; });
+        }
+
+        protected:
+        /// work runs tasks until none is left to start.
+        void work() {
+            for (;;) {
+                std::size_t index;
+                const std::function<void(std::size_t)>* task;
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    if (_next_task >= _number_of_tasks) {
+                        return;
+                    }
+                    index = _next_task;
+                    ++_next_task;
+                    task = _task;
+                }
+                (*task)(index);
+                std::unique_lock<std::mutex> lock(_mutex);
+                --_pending_tasks;
+                if (_pending_tasks == 0) {
+                    _tasks_done.notify_all();
+                }
+            }
+        }
+
+        bool _running;
+        uint64_t _generation;
+        const std::function<void(std::size_t)>* _task;
+        std::size_t _number_of_tasks;
+        std::size_t _next_task;
+        std::size_t _pending_tasks;
+        std::mutex _mutex;
+        std::condition_variable _tasks_available;
+        std::condition_variable _tasks_done;
+        std::vector<std::thread> _workers;
+    };
+
+    /// acquisition_statistics is a snapshot of the acquisition counters.
+    /// The histograms have logarithmic bins: bin i counts the values in [2^i, 2^(i + 1)), and bin 0 also counts 0.
+    /// dropped_words counts the words which are neither events nor overflow markers (out of the sensor's range), and
+    /// mode_discarded_events the events whose type the decode mode discards (threshold crossings in dvs_mode, for
+    /// instance). overflow_episodes counts the host FIFO overflows during which the overflow policy dropped events,
+    /// each reported once to the drop handler.
+    /// Read sizes are in words, and durations and latencies in nanoseconds:
+    ///     - read_durations: pipe-out read round trips
+    ///     - decode_durations: decoder calls
+    ///     - enqueue_latencies: delays between the end of a read and the publication of its events to the host FIFO
+    ///     - handler_latencies: delays between the estimated host time of a batch's first event and the handler call
+    ///     - handler_durations: handler calls
+    struct acquisition_statistics {
+        uint64_t decoded_events;
+        uint64_t pushed_events;
+        uint64_t read_bytes;
+        uint64_t reads;
+        uint64_t polls;
+        uint64_t empty_polls;
+        uint64_t maximum_board_fifo_words;
+        uint64_t maximum_host_fifo_events;
+        uint64_t dropped_words;
+        uint64_t mode_discarded_events;
+        uint64_t overflow_markers;
+        uint64_t filtered_events;
+        uint64_t overflow_dropped_events;
+        uint64_t overflow_discarded_events;
+        uint64_t spilled_words;
+        uint64_t overflow_episodes;
+        uint64_t board_overflows;
+        std::array<uint64_t, 32> read_sizes;
+        std::array<uint64_t, 32> read_durations;
+        std::array<uint64_t, 32> decode_durations;
+        std::array<uint64_t, 32> enqueue_latencies;
+        std::array<uint64_t, 32> handler_latencies;
+        std::array<uint64_t, 32> handler_durations;
+    };
+
+    /// accumulate adds the counters and histograms of other to statistics, and keeps the largest maxima.
+    inline void accumulate(acquisition_statistics& statistics, const acquisition_statistics& other) {
+        statistics.decoded_events += other.decoded_events;
+        statistics.pushed_events += other.pushed_events;
+        statistics.read_bytes += other.read_bytes;
+        statistics.reads += other.reads;
+        statistics.polls += other.polls;
+        statistics.empty_polls += other.empty_polls;
+        statistics.maximum_board_fifo_words =
+            std::max(statistics.maximum_board_fifo_words, other.maximum_board_fifo_words);
+        statistics.maximum_host_fifo_events =
+            std::max(statistics.maximum_host_fifo_events, other.maximum_host_fifo_events);
+        statistics.dropped_words += other.dropped_words;
+        statistics.mode_discarded_events += other.mode_discarded_events;
+        statistics.overflow_markers += other.overflow_markers;
+        statistics.filtered_events += other.filtered_events;
+        statistics.overflow_dropped_events += other.overflow_dropped_events;
+        statistics.overflow_discarded_events += other.overflow_discarded_events;
+        statistics.spilled_words += other.spilled_words;
+        statistics.overflow_episodes += other.overflow_episodes;
+        statistics.board_overflows += other.board_overflows;
+        for (std::size_t index = 0; index < statistics.read_sizes.size(); ++index) {
+            statistics.read_sizes[index] += other.read_sizes[index];
+            statistics.read_durations[index] += other.read_durations[index];
+            statistics.decode_durations[index] += other.decode_durations[index];
+            statistics.enqueue_latencies[index] += other.enqueue_latencies[index];
+            statistics.handler_latencies[index] += other.handler_latencies[index];
+            statistics.handler_durations[index] += other.handler_durations[index];
+        }
+    }
+
+    /// acquisition_counters accumulates the acquisition statistics.
+    /// Each counter is written by a single acquisition thread, hence updates are relaxed stores rather than
+    /// read-modify-write operations, and snapshots can be taken from any thread without locks.
+    class acquisition_counters {
+        public:
+        acquisition_counters() :
+            _decoded_events(0),
+            _pushed_events(0),
+            _read_bytes(0),
+            _reads(0),
+            _polls(0),
+            _empty_polls(0),
+            _maximum_board_fifo_words(0),
+            _maximum_host_fifo_events(0),
+            _dropped_words(0),
+            _mode_discarded_events(0),
+            _overflow_markers(0),
+            _filtered_events(0),
+            _overflow_dropped_events(0),
+            _overflow_discarded_events(0),
+            _spilled_words(0),
+            _overflow_episodes(0),
+            _board_overflows(0) {
+            for (std::size_t index = 0; index < _read_sizes.size(); ++index) {
+                _read_sizes[index].store(0, std::memory_order_relaxed);
+                _read_durations[index].store(0, std::memory_order_relaxed);
+                _decode_durations[index].store(0, std::memory_order_relaxed);
+                _enqueue_latencies[index].store(0, std::memory_order_relaxed);
+                _handler_latencies[index].store(0, std::memory_order_relaxed);
+                _handler_durations[index].store(0, std::memory_order_relaxed);
+            }
+        }
+        acquisition_counters(const acquisition_counters&) = delete;
+        acquisition_counters(acquisition_counters&&) = delete;
+        acquisition_counters& operator=(const acquisition_counters&) = delete;
+        acquisition_counters& operator=(acquisition_counters&&) = delete;
+        virtual ~acquisition_counters() {}
+
+        /// count_poll is called by the reading thread with the board's FIFO fill level after each poll.
+        void count_poll(std::size_t number_of_words) {
+            add(_polls, 1);
+            if (number_of_words == 0) {
+                add(_empty_polls, 1);
+            } else if (number_of_words > _maximum_board_fifo_words.load(std::memory_order_relaxed)) {
+                _maximum_board_fifo_words.store(number_of_words, std::memory_order_relaxed);
+            }
+        }
+
+        /// count_read is called by the reading thread after each pipe-out read.
+        void count_read(std::size_t number_of_words, std::chrono::nanoseconds duration) {
+            add(_reads, 1);
+            add(_read_bytes, number_of_words * 4);
+            add(_read_sizes[bin(static_cast<int64_t>(number_of_words))], 1);
+            add(_read_durations[bin(duration.count())], 1);
+        }
+
+        /// count_decode is called by the decoding thread after each call to decode.
+        /// number_of_markers can be derived from the t_offset increment (0x2000 per marker), and
+        /// number_of_discarded_events is the number of events whose type the decode mode discards.
+        void count_decode(
+            std::size_t number_of_words,
+            std::size_t number_of_events,
+            std::size_t number_of_markers,
+            std::size_t number_of_discarded_events,
+            std::chrono::nanoseconds duration) {
+            add(_decoded_events, number_of_events);
+            add(_overflow_markers, number_of_markers);
+            add(_mode_discarded_events, number_of_discarded_events);
+            add(_dropped_words, number_of_words - number_of_events - number_of_markers - number_of_discarded_events);
+            add(_decode_durations[bin(duration.count())], 1);
+        }
+
+        /// count_filter is called by the decoding thread with the number of events removed by the filters.
+        void count_filter(std::size_t number_of_events) {
+            add(_filtered_events, number_of_events);
+        }
+
+        /// count_overflow_drop is called by the decoding thread with the events dropped by the overflow policy.
+        /// The overflow markers of dropped words are still counted, since they advance the timestamps.
+        void count_overflow_drop(std::size_t number_of_events, std::size_t number_of_markers) {
+            add(_overflow_dropped_events, number_of_events);
+            add(_overflow_markers, number_of_markers);
+        }
+
+        /// count_overflow_discard is called by the dispatching thread with the published events it discards.
+        void count_overflow_discard(std::size_t number_of_events) {
+            add(_overflow_discarded_events, number_of_events);
+        }
+
+        /// count_spill is called by the decoding thread with the words stored in the spill file.
+        void count_spill(std::size_t number_of_words) {
+            add(_spilled_words, number_of_words);
+        }
+
+        /// count_overflow_episode is called by the decoding thread when the overflow policy starts dropping events.
+        void count_overflow_episode() {
+            add(_overflow_episodes, 1);
+        }
+
+        /// count_board_overflow is called by the reading thread when the board's FIFO overflowed.
+        void count_board_overflow() {
+            add(_board_overflows, 1);
+        }
+
+        /// count_push is called by the decoding thread after events are published to the host FIFO.
+        void count_push(std::size_t number_of_events, std::size_t host_fifo_events) {
+            add(_pushed_events, number_of_events);
+            if (host_fifo_events > _maximum_host_fifo_events.load(std::memory_order_relaxed)) {
+                _maximum_host_fifo_events.store(host_fifo_events, std::memory_order_relaxed);
+            }
+        }
+
+        /// count_enqueue is called by the decoding thread once the events of a read are published.
+        void count_enqueue(std::chrono::nanoseconds latency) {
+            add(_enqueue_latencies[bin(latency.count())], 1);
+        }
+
+        /// count_handler is called by the dispatching thread after each handler call.
+        void count_handler(std::chrono::nanoseconds latency, std::chrono::nanoseconds duration) {
+            add(_handler_latencies[bin(latency.count())], 1);
+            add(_handler_durations[bin(duration.count())], 1);
+        }
+
+        /// snapshot returns the current counters.
+        /// It can be called from any thread. Counters written by different threads are not read atomically
+        /// as a whole, hence they may be off by one read or decode relative to each other.
+        acquisition_statistics snapshot() const {
+            acquisition_statistics statistics;
+            statistics.decoded_events = _decoded_events.load(std::memory_order_relaxed);
+            statistics.pushed_events = _pushed_events.load(std::memory_order_relaxed);
+            statistics.read_bytes = _read_bytes.load(std::memory_order_relaxed);
+            statistics.reads = _reads.load(std::memory_order_relaxed);
+            statistics.polls = _polls.load(std::memory_order_relaxed);
+            statistics.empty_polls = _empty_polls.load(std::memory_order_relaxed);
+            statistics.maximum_board_fifo_words = _maximum_board_fifo_words.load(std::memory_order_relaxed);
+            statistics.maximum_host_fifo_events = _maximum_host_fifo_events.load(std::memory_order_relaxed);
+            statistics.dropped_words = _dropped_words.load(std::memory_order_relaxed);
+            statistics.mode_discarded_events = _mode_discarded_events.load(std::memory_order_relaxed);
+            statistics.overflow_markers = _overflow_markers.load(std::memory_order_relaxed);
+            statistics.filtered_events = _filtered_events.load(std::memory_order_relaxed);
+            statistics.overflow_dropped_events = _overflow_dropped_events.load(std::memory_order_relaxed);
+            statistics.overflow_discarded_events = _overflow_discarded_events.load(std::memory_order_relaxed);
+            statistics.spilled_words = _spilled_words.load(std::memory_order_relaxed);
+            statistics.overflow_episodes = _overflow_episodes.load(std::memory_order_relaxed);
+            statistics.board_overflows = _board_overflows.load(std::memory_order_relaxed);
+            for (std::size_t index = 0; index < _read_sizes.size(); ++index) {
+                statistics.read_sizes[index] = _read_sizes[index].load(std::memory_order_relaxed);
+                statistics.read_durations[index] = _read_durations[index].load(std::memory_order_relaxed);
+                statistics.decode_durations[index] = _decode_durations[index].load(std::memory_order_relaxed);
+                statistics.enqueue_latencies[index] = _enqueue_latencies[index].load(std::memory_order_relaxed);
+                statistics.handler_latencies[index] = _handler_latencies[index].load(std::memory_order_relaxed);
+                statistics.handler_durations[index] = _handler_durations[index].load(std::memory_order_relaxed);
+            }
+            return statistics;
+        }
+
+        protected:
+        /// add increments a counter which has a single writer.
+        static void add(std::atomic<uint64_t>& counter, uint64_t value) {
+            counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        /// bin returns the logarithmic histogram bin of a value.
+        /// Negative values, which can result from clock estimates, are counted in bin 0.
+        static std::size_t bin(int64_t value) {
+            std::size_t index = 0;
+            while (value > 1 && index < 31) {
+                value >>= 1;
+                ++index;
+            }
+            return index;
+        }
+
+        std::atomic<uint64_t> _decoded_events;
+        std::atomic<uint64_t> _pushed_events;
+        std::atomic<uint64_t> _read_bytes;
+        std::atomic<uint64_t> _reads;
+        std::atomic<uint64_t> _polls;
+        std::atomic<uint64_t> _empty_polls;
+        std::atomic<uint64_t> _maximum_board_fifo_words;
+        std::atomic<uint64_t> _maximum_host_fifo_events;
+        std::atomic<uint64_t> _dropped_words;
+        std::atomic<uint64_t> _mode_discarded_events;
+        std::atomic<uint64_t> _overflow_markers;
+        std::atomic<uint64_t> _filtered_events;
+        std::atomic<uint64_t> _overflow_dropped_events;
+        std::atomic<uint64_t> _overflow_discarded_events;
+        std::atomic<uint64_t> _spilled_words;
+        std::atomic<uint64_t> _overflow_episodes;
+        std::atomic<uint64_t> _board_overflows;
+        std::array<std::atomic<uint64_t>, 32> _read_sizes;
+        std::array<std::atomic<uint64_t>, 32> _read_durations;
+        std::array<std::atomic<uint64_t>, 32> _decode_durations;
+        std::array<std::atomic<uint64_t>, 32> _enqueue_latencies;
+        std::array<std::atomic<uint64_t>, 32> _handler_latencies;
+        std::array<std::atomic<uint64_t>, 32> _handler_durations;
+    };
+
+    /// clock_model maps sensor timestamps (in microseconds) to host time.
+    /// It is updated after each decoded read with the latest sensor time and the host time of the read, and fits
+    /// host time = offset + drift * sensor time with exponentially weighted least squares. The offset follows the
+    /// lower envelope of the samples, so that the host time of an event is estimated without the transfer delays.
+    /// The sensor time advances even without activity thanks to overflow markers, and the periodic fake events
+    /// (send_fake_event_periodically) provide additional samples.
+    class clock_model {
+        public:
+        clock_model() :
+            _samples(0),
+            _sensor_reference(0),
+            _host_reference(0),
+            _last_t(0),
+            _sensor_mean(0),
+            _host_mean(0),
+            _sensor_variance(0),
+            _covariance(0),
+            _minimum_deviation(0),
+            _sequence(0),
+            _published_sensor_time(0),
+            _published_host_time(0),
+            _published_slope(0) {}
+        clock_model(const clock_model&) = delete;
+        clock_model(clock_model&&) = delete;
+        clock_model& operator=(const clock_model&) = delete;
+        clock_model& operator=(clock_model&&) = delete;
+        virtual ~clock_model() {}
+
+        /// update adds a sample to the model.
+        /// It must only be called by the decoding thread.
+        void update(uint64_t t, std::chrono::steady_clock::time_point read_time) {
+            const auto host_time = std::chrono::duration_cast<std::chrono::nanoseconds>(read_time.time_since_epoch());
+            if (_samples == 0) {
+                _sensor_reference = t;
+                _host_reference = host_time;
+            } else if (t <= _last_t) {
+                return;
+            }
+            _last_t = t;
+            const auto x = static_cast<double>(t - _sensor_reference);
+            const auto y = static_cast<double>((host_time - _host_reference).count());
+            ++_samples;
+            const auto weight = std::max(1.0 / _samples, 1.0 / 256);
+            const auto x_delta = x - _sensor_mean;
+            const auto y_delta = y - _host_mean;
+            _sensor_mean += weight * x_delta;
+            _host_mean += weight * y_delta;
+            _sensor_variance = (1 - weight) * (_sensor_variance + weight * x_delta * x_delta);
+            _covariance = (1 - weight) * (_covariance + weight * x_delta * y_delta);
+            if (_sensor_variance <= 0) {
+                return;
+            }
+            const auto slope = _covariance / _sensor_variance;
+            _minimum_deviation =
+                std::min(y - (_host_mean + slope * (x - _sensor_mean)), _minimum_deviation * (1 - weight));
+            const auto sequence = _sequence.load(std::memory_order_relaxed);
+            _sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            _published_sensor_time.store(
+                _sensor_mean + static_cast<double>(_sensor_reference), std::memory_order_relaxed);
+            _published_host_time.store(
+                _host_mean + _minimum_deviation + static_cast<double>(_host_reference.count()),
+                std::memory_order_relaxed);
+            _published_slope.store(slope, std::memory_order_relaxed);
+            _sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        /// valid returns true once the model has enough samples to map timestamps.
+        /// It can be called from any thread.
+        bool valid() const {
+            return _sequence.load(std::memory_order_acquire) > 0;
+        }
+
+        /// host_time returns the estimated host time of a sensor timestamp.
+        /// It can be called from any thread (typically the handler's), and never blocks the decoding thread.
+        std::chrono::steady_clock::time_point host_time(uint64_t t) const {
+            double sensor_time = 0;
+            double host_time = 0;
+            double slope = 0;
+            load(sensor_time, host_time, slope);
+            return std::chrono::steady_clock::time_point(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(
+                    static_cast<int64_t>(host_time + slope * (static_cast<double>(t) - sensor_time)))));
+        }
+
+        /// drift returns the relative rate difference between the sensor clock and the host clock.
+        /// For example, 1e-5 means that the host clock advances by 1.00001 s per sensor second.
+        double drift() const {
+            double sensor_time = 0;
+            double host_time = 0;
+            double slope = 0;
+            load(sensor_time, host_time, slope);
+            return slope / 1e3 - 1;
+        }
+
+        protected:
+        /// load reads a consistent copy of the published parameters.
+        void load(double& sensor_time, double& host_time, double& slope) const {
+            for (;;) {
+                const auto sequence = _sequence.load(std::memory_order_acquire);
+                if (sequence % 2 == 0) {
+                    sensor_time = _published_sensor_time.load(std::memory_order_relaxed);
+                    host_time = _published_host_time.load(std::memory_order_relaxed);
+                    slope = _published_slope.load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (_sequence.load(std::memory_order_relaxed) == sequence) {
+                        return;
+                    }
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        std::size_t _samples;
+        uint64_t _sensor_reference;
+        std::chrono::nanoseconds _host_reference;
+        uint64_t _last_t;
+        double _sensor_mean;
+        double _host_mean;
+        double _sensor_variance;
+        double _covariance;
+        double _minimum_deviation;
+        std::atomic<uint64_t> _sequence;
+        std::atomic<double> _published_sensor_time;
+        std::atomic<double> _published_host_time;
+        std::atomic<double> _published_slope;
+    };
+
+    /// startup_report lists the durations of the camera startup phases and the number of round trips to the board.
+    /// The open duration covers the connection to the board, and the firmware duration the firmware check and
+    /// configuration (both are zero if an opened front panel was provided to the camera).
+    /// The acquisition start is the host time at which the board's timestamps start, estimated as the middle of the
+    /// round trip which starts the FPGA events reading.
+    struct startup_report {
+        bool firmware_reused;
+        std::chrono::nanoseconds open_duration;
+        std::chrono::nanoseconds firmware_duration;
+        std::chrono::nanoseconds biases_duration;
+        std::chrono::nanoseconds selection_duration;
+        std::chrono::nanoseconds mode_duration;
+        std::chrono::nanoseconds total_duration;
+        std::size_t wire_in_update_requests;
+        std::size_t wire_in_updates;
+        std::size_t trigger_ins;
+        std::chrono::steady_clock::time_point acquisition_start;
+    };
+
+    /// camera represents an ATIS connected to an Opal Kelly board.
+    class camera {
+        public:
+        /// available_serials returns the connected Opal Kelly ATIS cameras' serials.
+        static std::vector<std::string> available_serials() {
+            OpalKellyLegacy::okCFrontPanel opal_kelly_front_panel;
+            std::vector<std::string> serials;
+            serials.reserve(opal_kelly_front_panel.GetDeviceCount());
+            for (auto device_index = 0; device_index < opal_kelly_front_panel.GetDeviceCount(); ++device_index) {
+                serials.push_back(opal_kelly_front_panel.GetDeviceListSerial(device_index));
+            }
+            return serials;
+        }
+
+        /// default_parameter returns the default parameter used by the Opal Kelly ATIS.
+        static std::unique_ptr<sepia::parameter> default_parameter() {
+            return sepia::make_unique<sepia::object_parameter>(
+                "firmware",
+                sepia::make_unique<sepia::string_parameter>(
+                    sepia::join({sepia::dirname(SEPIA_DIRNAME), "resources", "atis.1.1.1.bit"})),
+                "exposure_measurement_trigger",
+                sepia::make_unique<sepia::enum_parameter>(
+                    "change_detection",
+                    std::unordered_set<std::string>({
+                        "change_detection",
+                        "sequential",
+                        "manual",
+                    })),
+                "columns_selection",
+                sepia::array_parameter::make_empty(sepia::make_unique<sepia::number_parameter>(304, 1, 305, true)),
+                "select_first_column",
+                sepia::make_unique<sepia::boolean_parameter>(true),
+                "rows_selection",
+                sepia::array_parameter::make_empty(sepia::make_unique<sepia::number_parameter>(240, 1, 241, true)),
+                "select_first_row",
+                sepia::make_unique<sepia::boolean_parameter>(true),
+                "selection_is_region_of_interest",
+                sepia::make_unique<sepia::boolean_parameter>(false),
+                "send_fake_event_periodically",
+                sepia::make_unique<sepia::boolean_parameter>(false),
+                "startup",
+                sepia::make_unique<sepia::object_parameter>(
+                    "reuse_configured_firmware",
+                    sepia::make_unique<sepia::boolean_parameter>(false),
+                    "firmware_version_wire_out",
+                    sepia::make_unique<sepia::number_parameter>(0, 0, 64, true),
+                    "firmware_version",
+                    sepia::make_unique<sepia::number_parameter>(0, 0, 4294967296.0, true),
+                    "merge_wire_ins",
+                    sepia::make_unique<sepia::boolean_parameter>(false)),
+                "acquisition",
+                sepia::make_unique<sepia::object_parameter>(
+                    "pipelined",
+                    sepia::make_unique<sepia::boolean_parameter>(false),
+                    "transfer_buffers",
+                    sepia::make_unique<sepia::number_parameter>(4, 2, 65, true),
+                    "transfer_buffer_words",
+                    sepia::make_unique<sepia::number_parameter>(1 << 20, 1 << 10, (1 << 24) + 1, true),
+                    "read_buffer_words",
+                    sepia::make_unique<sepia::number_parameter>(1 << 24, 1 << 10, (1 << 24) + 1, true),
+                    "huge_pages",
+                    sepia::make_unique<sepia::boolean_parameter>(false),
+                    "streaming",
+                    sepia::make_unique<sepia::object_parameter>(
+                        "chunk_words",
+                        sepia::make_unique<sepia::number_parameter>(0, 0, (1 << 24) + 1, true),
+                        "block_size",
+                        sepia::make_unique<sepia::number_parameter>(0, 0, (1 << 14) + 1, true)),
+                    "polling",
+                    sepia::make_unique<sepia::object_parameter>(
+                        "policy",
+                        sepia::make_unique<sepia::enum_parameter>(
+                            "fixed",
+                            std::unordered_set<std::string>({
+                                "fixed",
+                                "adaptive",
+                            })),
+                        "latency_target",
+                        sepia::make_unique<sepia::number_parameter>(1000, 10, 1000001, true),
+                        "cpu_budget",
+                        sepia::make_unique<sepia::number_parameter>(0.1, 0.001, 1, false)),
+                    "raw",
+                    sepia::make_unique<sepia::object_parameter>(
+                        "direct_io",
+                        sepia::make_unique<sepia::boolean_parameter>(false),
+                        "asynchronous_writes",
+                        sepia::make_unique<sepia::boolean_parameter>(true),
+                        "block_size",
+                        sepia::make_unique<sepia::number_parameter>(1 << 22, 1 << 12, (1 << 30) + 1, true),
+                        "blocks",
+                        sepia::make_unique<sepia::number_parameter>(8, 2, 257, true)),
+                    "decoding",
+                    sepia::make_unique<sepia::object_parameter>(
+                        "threads",
+                        sepia::make_unique<sepia::number_parameter>(1, 1, 65, true),
+                        "minimum_words",
+                        sepia::make_unique<sepia::number_parameter>(1 << 18, 1 << 10, (1 << 24) + 1, true)),
+                    "overflow",
+                    sepia::make_unique<sepia::object_parameter>(
+                        "policy",
+                        sepia::make_unique<sepia::enum_parameter>(
+                            "fail",
+                            std::unordered_set<std::string>({
+                                "fail",
+                                "drop_newest",
+                                "drop_oldest",
+                                "drop_threshold_crossings",
+                                "back_pressure",
+                                "spill",
+                            })),
+                        "spill_filename",
+                        sepia::make_unique<sepia::string_parameter>(""),
+                        "spill_words",
+                        sepia::make_unique<sepia::number_parameter>(1 << 26, 1 << 10, (1ll << 32) + 1, true)),
+                    "threads",
+                    sepia::make_unique<sepia::object_parameter>(
+                        "reading_cpu",
+                        sepia::make_unique<sepia::number_parameter>(-1, -1, 4096, true),
+                        "decoding_cpu",
+                        sepia::make_unique<sepia::number_parameter>(-1, -1, 4096, true),
+                        "dispatching_cpu",
+                        sepia::make_unique<sepia::number_parameter>(-1, -1, 4096, true),
+                        "scheduling",
+                        sepia::make_unique<sepia::enum_parameter>(
+                            "default",
+                            std::unordered_set<std::string>({
+                                "default",
+                                "fifo",
+                                "round_robin",
+                            })),
+                        "priority",
+                        sepia::make_unique<sepia::number_parameter>(10, 1, 100, true))),
+                "apply_selection_to",
+                sepia::make_unique<sepia::enum_parameter>(
+                    "change_detection",
+                    std::unordered_set<std::string>({
+                        "change_detection",
+                        "exposure_measurement",
+                        "change_detection_and_exposure_measurement",
+                    })),
+                "change_detection",
+                sepia::make_unique<sepia::object_parameter>(
+                    "reset_switch_bulk_potential",
+                    sepia::make_unique<sepia::char_parameter>(207),
+                    "photoreceptor_feedback",
+                    sepia::make_unique<sepia::char_parameter>(216),
+                    "refractory_period",
+                    sepia::make_unique<sepia::char_parameter>(220),
+                    "follower",
+                    sepia::make_unique<sepia::char_parameter>(235),
+                    "event_source_amplifier",
+                    sepia::make_unique<sepia::char_parameter>(38),
+                    "on_event_threshold",
+                    sepia::make_unique<sepia::char_parameter>(48),
+                    "off_event_threshold",
+                    sepia::make_unique<sepia::char_parameter>(34),
+                    "off_event_inverter",
+                    sepia::make_unique<sepia::char_parameter>(61),
+                    "cascode_photoreceptor_feedback",
+                    sepia::make_unique<sepia::char_parameter>(154)),
+                "exposure_measurement",
+                sepia::make_unique<sepia::object_parameter>(
+                    "comparator_tail",
+                    sepia::make_unique<sepia::char_parameter>(40),
+                    "comparator_hysteresis",
+                    sepia::make_unique<sepia::char_parameter>(35),
+                    "comparator_output_stage",
+                    sepia::make_unique<sepia::char_parameter>(51),
+                    "upper_threshold",
+                    sepia::make_unique<sepia::char_parameter>(247),
+                    "lower_threshold",
+                    sepia::make_unique<sepia::char_parameter>(231)),
+                "pullup",
+                sepia::make_unique<sepia::object_parameter>(
+                    "exposure_measurement_abscissa_request",
+                    sepia::make_unique<sepia::char_parameter>(127),
+                    "exposure_measurement_ordinate_request",
+                    sepia::make_unique<sepia::char_parameter>(155),
+                    "change_detection_abscissa_request",
+                    sepia::make_unique<sepia::char_parameter>(151),
+                    "change_detection_ordinate_request",
+                    sepia::make_unique<sepia::char_parameter>(120),
+                    "abscissa_acknoledge",
+                    sepia::make_unique<sepia::char_parameter>(162),
+                    "abscissa_encoder",
+                    sepia::make_unique<sepia::char_parameter>(162),
+                    "ordinate_encoder",
+                    sepia::make_unique<sepia::char_parameter>(120)),
+                "control",
+                sepia::make_unique<sepia::object_parameter>(
+                    "exposure_measurement_timeout",
+                    sepia::make_unique<sepia::char_parameter>(42),
+                    "sequential_exposure_measurement_timeout",
+                    sepia::make_unique<sepia::char_parameter>(45),
+                    "abscissa_acknoledge_timeout",
+                    sepia::make_unique<sepia::char_parameter>(56),
+                    "latch_cell_scan_pulldown",
+                    sepia::make_unique<sepia::char_parameter>(134),
+                    "abscissa_request_pulldown",
+                    sepia::make_unique<sepia::char_parameter>(87)));
+        }
+
+        /// width returns the sensor width.
+        static constexpr uint16_t width() {
+            return 304;
+        }
+
+        /// height returns the sensor height.
+        static constexpr uint16_t height() {
+            return 240;
+        }
+
+        /// selection_fill computes the selection bits of a parameter, in the order expected by the board
+        /// (304 columns then 240 rows, both reversed). A true bit selects the pixels of the column or row.
+        static std::vector<bool> selection_fill(const sepia::parameter& parameter) {
+            // compute the columns fill bits
+            auto fill = std::vector<bool>();
+            fill.reserve(544);
+            if (parameter.get_array_parameter({"columns_selection"}).size() > 0) {
+                auto state = parameter.get_boolean({"select_first_column"});
+                auto first_pass = true;
+                while (fill.size() < 304) {
+                    for (const auto& column_count : parameter.get_array_parameter({"columns_selection"})) {
+                        for (uint16_t index = 0; index < static_cast<uint16_t>(column_count->get_number({})); ++index) {
+                            if (fill.size() >= 304) {
+                                if (first_pass) {
+                                    throw std::runtime_error("The columns selection sum is larger than 304");
+                                } else {
+                                    break;
+                                }
+                            }
+                            fill.push_back(state);
+                        }
+                        state = !state;
+                    }
+                    if (first_pass) {
+                        first_pass = false;
+                    }
+                }
+                std::reverse(fill.begin(), fill.end());
+            } else {
+                fill = std::vector<bool>(304);
+            }
+
+            // compute the rows fill bits
+            if (parameter.get_array_parameter({"rows_selection"}).size() > 0) {
+                auto state = parameter.get_boolean({"select_first_row"});
+                auto first_pass = true;
+                while (fill.size() < 544) {
+                    for (const auto& column_count : parameter.get_array_parameter({"rows_selection"})) {
+                        for (uint16_t index = 0; index < static_cast<uint16_t>(column_count->get_number({})); ++index) {
+                            if (fill.size() >= 544) {
+                                if (first_pass) {
+                                    throw std::runtime_error("The rows selection sum is larger than 240");
+                                } else {
+                                    break;
+                                }
+                            }
+                            fill.push_back(state);
+                        }
+                        if (fill.size() >= 544) {
+                            break;
+                        }
+                        state = !state;
+                    }
+                    if (first_pass) {
+                        first_pass = false;
+                    }
+                }
+                std::reverse(fill.begin() + 304, fill.end());
+            } else {
+                auto fill_rows = std::vector<bool>(240);
+                fill.insert(fill.end(), fill_rows.begin(), fill_rows.end());
+            }
+            return fill;
+        }
+
+        /// selection_packs packs selection bits as the 16-bit values sent to the board (a cleared bit selects).
+        static std::vector<uint16_t> selection_packs(const std::vector<bool>& fill) {
+            std::vector<uint16_t> packs(fill.size() / 16, 0);
+            for (std::size_t index = 0; index < packs.size() * 16; ++index) {
+                if (!fill[index]) {
+                    packs[index / 16] |= static_cast<uint16_t>(1 << (index % 16));
+                }
+            }
+            return packs;
+        }
+
+        /// configuration contains the settings for the digital-to-analog converters on the FPGA.
+        static std::
+            unordered_map<std::string, std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>>
+            configuration() {
+            return {
+                {"change_detection",
+                 {
+                     {"reset_switch_bulk_potential", {{"address", 0x02}, {"tension", 0x5900}}},
+                     {"photoreceptor_feedback", {{"address", 0x03}, {"tension", 0x5900}}},
+                     {"refractory_period", {{"address", 0x04}, {"tension", 0x5900}}},
+                     {"follower", {{"address", 0x05}, {"tension", 0x5900}}},
+                     {"event_source_amplifier", {{"address", 0x06}, {"tension", 0x7900}}},
+                     {"on_event_threshold", {{"address", 0x07}, {"tension", 0x7900}}},
+                     {"off_event_threshold", {{"address", 0x08}, {"tension", 0x7900}}},
+                     {"off_event_inverter", {{"address", 0x09}, {"tension", 0x7900}}},
+                     {"cascode_photoreceptor_feedback", {{"address", 0x0a}, {"tension", 0x7900}}},
+                 }},
+                {"exposure_measurement",
+                 {
+                     {"comparator_tail", {{"address", 0x0b}, {"tension", 0x7900}}},
+                     {"comparator_hysteresis", {{"address", 0x0c}, {"tension", 0x7900}}},
+                     {"comparator_output_stage", {{"address", 0x0d}, {"tension", 0x7900}}},
+                     {"upper_threshold", {{"address", 0x0e}, {"tension", 0x5900}}},
+                     {"lower_threshold", {{"address", 0x0f}, {"tension", 0x5900}}},
+                 }},
+                {"pullup",
+                 {
+                     {"exposure_measurement_abscissa_request", {{"address", 0x10}, {"tension", 0x5900}}},
+                     {"exposure_measurement_ordinate_request", {{"address", 0x11}, {"tension", 0x5900}}},
+                     {"change_detection_abscissa_request", {{"address", 0x12}, {"tension", 0x5900}}},
+                     {"change_detection_ordinate_request", {{"address", 0x13}, {"tension", 0x5900}}},
+                     {"abscissa_acknoledge", {{"address", 0x14}, {"tension", 0x5900}}},
+                     {"abscissa_encoder", {{"address", 0x15}, {"tension", 0x7900}}},
+                     {"ordinate_encoder", {{"address", 0x16}, {"tension", 0x7900}}},
+                 }},
+                {"control",
+                 {
+                     {"exposure_measurement_timeout", {{"address", 0x17}, {"tension", 0x7900}}},
+                     {"sequential_exposure_measurement_timeout", {{"address", 0x18}, {"tension", 0x7900}}},
+                     {"abscissa_acknoledge_timeout", {{"address", 0x19}, {"tension", 0x7900}}},
+                     {"latch_cell_scan_pulldown", {{"address", 0x1a}, {"tension", 0x7900}}},
+                     {"abscissa_request_pulldown", {{"address", 0x1b}, {"tension", 0x7900}}},
+                 }},
+                {"static",
+                 {
+                     {"reset_t", {{"address", 0x00}, {"tension", 0x5900}, {"value", 0}}},
+                     {"test_event", {{"address", 0x01}, {"tension", 0x7900}, {"value", 0}}},
+                     {"reset_photodiodes", {{"address", 0x1c}, {"tension", 0x00}, {"value", 3}}},
+                 }},
+            };
+        }
+
+        camera(
+            std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter,
+            std::string serial,
+            std::chrono::milliseconds sleep_duration,
+            std::unique_ptr<front_panel> opened_front_panel) :
+            _parameter(default_parameter()),
+            _acquisition_running(true),
+            _partial_block_pending(false),
+            _idle_handover(false),
+            _spilling(false),
+            _t_offset(0),
+            _startup(),
+            _selection_mode(0),
+            _selection_mode_written(false) {
+            const auto startup_begin = std::chrono::steady_clock::now();
+            _parameter->parse_or_load(std::move(unvalidated_parameter));
+            _polling_scheduler = sepia::make_unique<polling_scheduler>(
+                _parameter->get_string({"acquisition", "polling", "policy"}) == "adaptive",
+                sleep_duration,
+                std::chrono::microseconds(
+                    static_cast<int64_t>(_parameter->get_number({"acquisition", "polling", "latency_target"}))),
+                _parameter->get_number({"acquisition", "polling", "cpu_budget"}));
+
+            // open the Opal Kelly board unless a front panel was provided
+            if (!opened_front_panel) {
+                // check wether the serial exists and is an ATIS camera
+                // default to the first serial found if an empty string is given as serial
+                {
+                    const auto serials = available_serials();
+                    if (serials.empty()) {
+                        throw sepia::no_device_connected("Opal Kelly ATIS");
+                    } else {
+                        if (serial.empty()) {
+                            serial = *serials.begin();
+                        } else if (std::find(serials.begin(), serials.end(), serial) == serials.end()) {
+                            throw sepia::no_device_connected("Opal Kelly ATIS");
+                        }
+                    }
+                }
+                auto board_front_panel = sepia::make_unique<opal_kelly_front_panel>(
+                    serial,
+                    _parameter->get_string({"firmware"}),
+                    _parameter->get_boolean({"startup", "reuse_configured_firmware"}),
+                    static_cast<int32_t>(_parameter->get_number({"startup", "firmware_version_wire_out"})),
+                    static_cast<uint32_t>(_parameter->get_number({"startup", "firmware_version"})));
+                _startup.firmware_reused = board_front_panel->firmware_reused();
+                _startup.firmware_duration = board_front_panel->firmware_duration();
+                opened_front_panel = std::move(board_front_panel);
+            }
+            _front_panel = sepia::make_unique<batched_front_panel>(
+                std::move(opened_front_panel), _parameter->get_boolean({"startup", "merge_wire_ins"}));
+            _serial = _front_panel->serial();
+            auto phase_begin = std::chrono::steady_clock::now();
+            _startup.open_duration = phase_begin - startup_begin - _startup.firmware_duration;
+
+            // open the biases and selection settings
+            _front_panel->set_wire_in_value(0x00, 1 << 5, 1 << 5);
+            _front_panel->update_wire_ins();
+
+            // initialise the digital-to-analog converters (biases setup)
+            for (const auto& category_pair : configuration()) {
+                for (const auto& setting_pair : category_pair.second) {
+                    write_bias(
+                        setting_pair.second,
+                        category_pair.first == "static" ?
+                            setting_pair.second.at("value") :
+                            static_cast<uint32_t>(_parameter->get_number({category_pair.first, setting_pair.first})));
+                }
+            }
+            _front_panel->activate_trigger_in(0x40, 6);
+
+            {
+                const auto now = std::chrono::steady_clock::now();
+                _startup.biases_duration = now - phase_begin;
+                phase_begin = now;
+            }
+
+            // load the region of interest parameters
+            if (_parameter->get_array_parameter({"columns_selection"}).size() > 0
+                || _parameter->get_array_parameter({"rows_selection"}).size() > 0) {
+                write_selection(selection_packs(selection_fill(*_parameter)));
+                write_selection_mode(
+                    _parameter->get_boolean({"selection_is_region_of_interest"}),
+                    _parameter->get_string({"apply_selection_to"}));
+            }
+
+            {
+                const auto now = std::chrono::steady_clock::now();
+                _startup.selection_duration = now - phase_begin;
+                phase_begin = now;
+            }
+
+            // close the biases and selection settings
+            _front_panel->set_wire_in_value(0x00, 0, 1 << 5);
+            _front_panel->update_wire_ins();
+
+            // load the exposure measurement trigger
+            if (_parameter->get_string({"exposure_measurement_trigger"}) == "change_detection") {
+                _front_panel->set_wire_in_value(0x00, 1 << 0, 1 << 0);
+                _front_panel->update_wire_ins();
+            } else if (_parameter->get_string({"exposure_measurement_trigger"}) == "sequential") {
+                _front_panel->set_wire_in_value(0x00, 1 << 1, 1 << 1);
+                _front_panel->update_wire_ins();
+
+                if (_parameter->get_string({"apply_selection_to"}) == "change_detection"
+                    || _parameter->get_string({"apply_selection_to"}) == "change_detection_and_exposure_measurement") {
+                    _front_panel->set_wire_in_value(0x00, 1 << 0, 1 << 0);
+                    _front_panel->update_wire_ins();
+                }
+            }
+
+            // reset the Atis FIFO
+            _front_panel->activate_trigger_in(0x40, 7);
+
+            // reset the handlers
+            _front_panel->activate_trigger_in(0x40, 2);
+
+            // enable periodic fake events
+            if (_parameter->get_boolean({"send_fake_event_periodically"})) {
+                _front_panel->set_wire_in_value(0x00, 1 << 12, 1 << 12);
+                _front_panel->update_wire_ins();
+            }
+
+            // start the FPGA events reading
+            _front_panel->set_wire_in_value(0x00, 1 << 10, 1 << 10);
+            _front_panel->update_wire_ins();
+            {
+                const auto flush_begin = std::chrono::steady_clock::now();
+                _front_panel->flush();
+                const auto now = std::chrono::steady_clock::now();
+                _startup.acquisition_start = flush_begin + (now - flush_begin) / 2;
+                _startup.mode_duration = now - phase_begin;
+                _startup.total_duration = now - startup_begin;
+            }
+            _startup.wire_in_update_requests = _front_panel->wire_in_update_requests();
+            _startup.wire_in_updates = _front_panel->wire_in_updates();
+            _startup.trigger_ins = _front_panel->trigger_ins();
+
+            // create the transfer buffers shared by the reading and decoding threads
+            _huge_pages = _parameter->get_boolean({"acquisition", "huge_pages"});
+            // block pipe transfers are powers of two, and reads are multiples of both the block and the board's
+            // 32-word fill level granularity
+            _block_size = static_cast<std::size_t>(_parameter->get_number({"acquisition", "streaming", "block_size"}));
+            if (_block_size > 0 && _block_size < 16) {
+                throw std::runtime_error("the streaming block size must be 0 (disabled) or at least 16 bytes");
+            }
+            while ((_block_size & (_block_size - 1)) != 0) {
+                _block_size &= _block_size - 1;
+            }
+            _read_granularity_words = std::max(_block_size / 4, static_cast<std::size_t>(32));
+            const auto read_words = [&](const std::vector<std::string>& keys) -> std::size_t {
+                const auto words = static_cast<std::size_t>(_parameter->get_number(keys));
+                return words == 0 ? 0 : std::max(words - words % _read_granularity_words, _read_granularity_words);
+            };
+            _read_buffer_words = read_words({"acquisition", "read_buffer_words"});
+            _chunk_words = read_words({"acquisition", "streaming", "chunk_words"});
+            if (_parameter->get_boolean({"acquisition", "pipelined"})) {
+                _transfer_ring = sepia::make_unique<transfer_ring>(
+                    static_cast<std::size_t>(_parameter->get_number({"acquisition", "transfer_buffers"})),
+                    read_words({"acquisition", "transfer_buffer_words"}),
+                    _huge_pages);
+            } else if (_chunk_words > 0) {
+                // streaming reads are decoded by a dedicated thread while the next chunk is read
+                _transfer_ring = sepia::make_unique<transfer_ring>(
+                    static_cast<std::size_t>(_parameter->get_number({"acquisition", "transfer_buffers"})),
+                    _chunk_words,
+                    _huge_pages);
+            }
+
+            // select the overflow policy
+            {
+                const auto policy = _parameter->get_string({"acquisition", "overflow", "policy"});
+                if (policy == "drop_newest") {
+                    _overflow_policy = overflow_policy::drop_newest;
+                } else if (policy == "drop_oldest") {
+                    _overflow_policy = overflow_policy::drop_oldest;
+                } else if (policy == "drop_threshold_crossings") {
+                    _overflow_policy = overflow_policy::drop_threshold_crossings;
+                } else if (policy == "back_pressure") {
+                    _overflow_policy = overflow_policy::back_pressure;
+                } else if (policy == "spill") {
+                    _overflow_policy = overflow_policy::spill;
+                } else {
+                    _overflow_policy = overflow_policy::fail;
+                }
+            }
+
+            // read the threads placement, applied by each thread before it touches its buffers
+            _thread_cpus[static_cast<std::size_t>(thread_role::reading)] =
+                static_cast<int>(_parameter->get_number({"acquisition", "threads", "reading_cpu"}));
+            _thread_cpus[static_cast<std::size_t>(thread_role::decoding)] =
+                static_cast<int>(_parameter->get_number({"acquisition", "threads", "decoding_cpu"}));
+            _thread_cpus[static_cast<std::size_t>(thread_role::dispatching)] =
+                static_cast<int>(_parameter->get_number({"acquisition", "threads", "dispatching_cpu"}));
+            _scheduling_policy = _parameter->get_string({"acquisition", "threads", "scheduling"});
+            _scheduling_priority = static_cast<int>(_parameter->get_number({"acquisition", "threads", "priority"}));
+            _placement = placement_report{{-1, false}, {-1, false}, {-1, false}};
+        }
+        camera(const camera&) = delete;
+        camera(camera&&) = delete;
+        camera& operator=(const camera&) = delete;
+        camera& operator=(camera&&) = delete;
+        virtual ~camera() {
+            stop();
+        }
+
+        /// trigger sends a trigger signal to the camera.
+        /// with default settings, this signal will trigger a change detection on every pixel.
+        virtual void trigger() {
+            std::lock_guard<std::mutex> lock(_configuration_mutex);
+            _front_panel->set_wire_in_value(0x00, 1 << 6, 1 << 6);
+            _front_panel->update_wire_ins();
+            _front_panel->set_wire_in_value(0x00, 0 << 6, 1 << 6);
+            _front_panel->update_wire_ins();
+        }
+
+        /// poll_rate returns the number of times per second that the acquisition loop polls the board's FIFO.
+        /// It can be used to monitor the polling policy's trade-off between latency and processor usage.
+        virtual double poll_rate() const {
+            return _polling_scheduler->poll_rate();
+        }
+
+        /// statistics returns a snapshot of the acquisition counters.
+        /// It can be called from a monitoring thread without blocking the acquisition threads.
+        virtual acquisition_statistics statistics() const {
+            return _counters.snapshot();
+        }
+
+        /// startup returns the durations of the startup phases and the number of round trips to the board.
+        virtual startup_report startup() const {
+            return _startup;
+        }
+
+        /// placement returns the placements applied to the acquisition threads.
+        /// The read buffers, the transfer ring and the host FIFO are not initialised, hence their pages are allocated
+        /// on the first touch by the placed threads, which makes them local to the pinned cores' NUMA node under the
+        /// default memory policy. Multi-camera threads are not placed, and neither are their FIFOs and buffers.
+        virtual placement_report placement() const {
+            std::lock_guard<std::mutex> lock(_placement_mutex);
+            return _placement;
+        }
+
+        /// memory returns the host memory allocated for the camera's buffers, and the part which is resident.
+        /// It can be called from a monitoring thread, but it inspects every page of the buffers.
+        virtual memory_statistics memory() const {
+            memory_statistics statistics{};
+            if (_transfer_ring) {
+                statistics.allocated_read_buffers_bytes = _transfer_ring->allocated_size();
+                statistics.resident_read_buffers_bytes = _transfer_ring->resident_size();
+            } else if (_read_buffer) {
+                statistics.allocated_read_buffers_bytes = _read_buffer->size();
+                statistics.resident_read_buffers_bytes = _read_buffer->resident_size();
+            }
+            return statistics;
+        }
+
+        /// host_clock returns the model mapping sensor timestamps to host time.
+        /// It can be used from the events handler to estimate how stale an event is.
+        virtual const clock_model& host_clock() const {
+            return _host_clock;
+        }
+
+        /// set_bias changes a bias while the acquisition is running.
+        /// category must be one of change_detection, exposure_measurement, pullup and control.
+        /// The change is not recorded in the parameter, hence a later update_parameter restores the parameter's value.
+        virtual void set_bias(const std::string& category, const std::string& name, uint8_t value) {
+            const auto settings = configuration();
+            const auto category_settings = settings.find(category);
+            if (category == "static" || category_settings == settings.end()
+                || category_settings->second.find(name) == category_settings->second.end()) {
+                throw std::runtime_error("unknown bias '" + category + "." + name + "'");
+            }
+            std::lock_guard<std::mutex> lock(_configuration_mutex);
+            open_settings();
+            write_bias(category_settings->second.at(name), value);
+            _front_panel->activate_trigger_in(0x40, 6);
+            close_settings();
+        }
+
+        /// update_parameter loads a partial parameter over the current one while the acquisition is running,
+        /// and reprograms the biases and the selection which differ from the values last sent to the board.
+        /// A parameter clearing a selection loaded by the previous one is rejected, since the board has no
+        /// unselected state: set_selection must be used instead.
+        /// The other parameters are only read when the camera is created, and changing them has no effect.
+        virtual void update_parameter(std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter) {
+            std::lock_guard<std::mutex> lock(_configuration_mutex);
+            auto parameter = _parameter->clone();
+            parameter->parse_or_load(std::move(unvalidated_parameter));
+            const auto has_selection = [](const sepia::parameter& candidate) {
+                return candidate.get_array_parameter({"columns_selection"}).size() > 0
+                       || candidate.get_array_parameter({"rows_selection"}).size() > 0;
+            };
+            if (!has_selection(*parameter) && has_selection(*_parameter)) {
+                throw std::runtime_error("the selection cannot be cleared while the acquisition is running");
+            }
+            const auto packs = has_selection(*parameter) ? selection_packs(selection_fill(*parameter)) :
+                                                           std::vector<uint16_t>();
+            open_settings();
+            auto biases_changed = false;
+            for (const auto& category_pair : configuration()) {
+                if (category_pair.first == "static") {
+                    continue;
+                }
+                for (const auto& setting_pair : category_pair.second) {
+                    const auto value =
+                        static_cast<uint32_t>(parameter->get_number({category_pair.first, setting_pair.first}));
+                    const auto written = _bias_values.find(setting_pair.second.at("address"));
+                    if (written == _bias_values.end() || written->second != value) {
+                        write_bias(setting_pair.second, value);
+                        biases_changed = true;
+                    }
+                }
+            }
+            if (biases_changed) {
+                _front_panel->activate_trigger_in(0x40, 6);
+            }
+            if (!packs.empty()) {
+                write_selection(packs);
+                write_selection_mode(
+                    parameter->get_boolean({"selection_is_region_of_interest"}),
+                    parameter->get_string({"apply_selection_to"}));
+            }
+            close_settings();
+            _parameter = std::move(parameter);
+        }
+
+        /// set_drop_handler sets the function called when an overflow policy drops events, once per overflow episode.
+        /// It is called by the acquisition threads, hence it must return quickly. The exception handler is reserved
+        /// for errors which stop the acquisition, and drops are counted in the statistics whether or not a handler
+        /// is set.
+        virtual void set_drop_handler(std::function<void(const events_dropped&)> handle_drop) {
+            std::lock_guard<std::mutex> lock(_drop_mutex);
+            _handle_drop = std::move(handle_drop);
+        }
+
+        /// set_selection replaces the selection while the acquisition is running.
+        /// columns must have 304 elements and rows 240, and true elements select the pixels of the column or row.
+        /// The selection mode (selection_is_region_of_interest and apply_selection_to) is not changed.
+        /// Only the 16-bit packs which differ from the board's are sent.
+        virtual void set_selection(const std::vector<bool>& columns, const std::vector<bool>& rows) {
+            if (columns.size() != 304 || rows.size() != 240) {
+                throw std::runtime_error("the selection must have 304 columns and 240 rows");
+            }
+            std::vector<bool> fill(columns.rbegin(), columns.rend());
+            fill.insert(fill.end(), rows.rbegin(), rows.rend());
+            const auto packs = selection_packs(fill);
+            std::lock_guard<std::mutex> lock(_configuration_mutex);
+            open_settings();
+            write_selection(packs);
+            close_settings();
+        }
+
+        protected:
+        /// handle_words is called by the acquisition threads with the words read from the pipe-out.
+        /// read_time is the host time at which the read completed.
+        virtual void handle_words(
+            const uint8_t* data,
+            std::size_t number_of_words,
+            std::chrono::steady_clock::time_point read_time) = 0;
+
+        /// handle_acquisition_exception is called when an acquisition thread stops on an exception.
+        virtual void handle_acquisition_exception(std::exception_ptr exception) = 0;
+
+        /// start launches the acquisition threads.
+        /// It must be called at the end of the derived class constructor, since the threads call handle_words.
+        void start() {
+            if (!_transfer_ring) {
+                _read_buffer = sepia::make_unique<aligned_buffer>(_read_buffer_words * 4, _huge_pages);
+            }
+            _acquisition_loop = std::thread([this]() -> void {
+                try {
+                    place(thread_role::reading);
+                    while (_acquisition_running.load(std::memory_order_relaxed)) {
+                        std::chrono::nanoseconds poll_duration;
+                        const auto number_of_words =
+                            poll(_read_buffer ? _read_buffer->data() : nullptr, poll_duration);
+                        if (!_acquisition_running.load(std::memory_order_relaxed)) {
+                            break;
+                        }
+                        _polling_scheduler->wait(number_of_words, poll_duration);
+                    }
+                } catch (...) {
+                    stop_with_exception(std::current_exception());
+                }
+            });
+            if (_transfer_ring) {
+                _decoding_loop = std::thread([this]() -> void {
+                    try {
+                        place(thread_role::decoding);
+                        for (;;) {
+                            std::size_t number_of_words = 0;
+                            std::chrono::steady_clock::time_point read_time;
+                            const auto data = _transfer_ring->readable(number_of_words, read_time);
+                            if (!data) {
+                                break;
+                            }
+                            handle_words(data, number_of_words, read_time);
+                            _transfer_ring->release();
+                        }
+                    } catch (...) {
+                        stop_with_exception(std::current_exception());
+                    }
+                });
+            }
+        }
+
+        /// place applies the configured placement to the calling thread, and records the applied placement.
+        void place(thread_role role) {
+            const auto placement = place_current_thread(
+                _thread_cpus[static_cast<std::size_t>(role)], _scheduling_policy, _scheduling_priority);
+            std::lock_guard<std::mutex> lock(_placement_mutex);
+            switch (role) {
+                case thread_role::reading:
+                    _placement.reading = placement;
+                    break;
+                case thread_role::decoding:
+                    _placement.decoding = placement;
+                    break;
+                case thread_role::dispatching:
+                    _placement.dispatching = placement;
+                    break;
+            }
+        }
+
+        /// handle_idle is called by the reading thread after each empty poll.
+        /// If _idle_handover is set, handle_words is also called without words after each empty poll, by the
+        /// decoding thread if the acquisition uses a transfer ring.
+        virtual void handle_idle() {}
+
+        /// poll retrieves the board's FIFO fill level, reads the available words and passes them to handle_words,
+        /// or to the transfer ring if the acquisition is pipelined or streaming.
+        /// events_data must hold read_buffer_words() * 4 bytes unless the acquisition uses a transfer ring.
+        /// Fill levels larger than read_buffer_words() are read over several polls. If streaming is enabled, the
+        /// whole fill level is read in chunks of at most chunk_words, and each chunk is handed over once read, so that
+        /// the first words of a large backlog do not wait for the last ones.
+        /// It returns the fill level, and poll_duration is set to the fill level request's round-trip time.
+        std::size_t poll(uint8_t* events_data, std::chrono::nanoseconds& poll_duration) {
+            const auto poll_begin = std::chrono::steady_clock::now();
+            _front_panel->update_wire_outs();
+            poll_duration = std::chrono::steady_clock::now() - poll_begin;
+            auto number_of_words = (static_cast<std::size_t>(_front_panel->wire_out_value(0x21)) << 21)
+                                   + (static_cast<std::size_t>(_front_panel->wire_out_value(0x20)) << 5);
+            _counters.count_poll(number_of_words);
+            if (number_of_words > 1 << 24) {
+                if (_front_panel->serial() != _serial) {
+                    throw sepia::device_disconnected("Opal Kelly ATIS");
+                } else if (_overflow_policy == overflow_policy::fail) {
+                    throw std::runtime_error("Opal Kelly ATIS's FIFO overflow");
+                }
+                _counters.count_board_overflow();
+                handle_drop(events_dropped("Opal Kelly ATIS's FIFO overflow, events were lost on the board"));
+                number_of_words = 1 << 24;
+            }
+            if (number_of_words > 0) {
+                auto maximum_read_words = _transfer_ring ? _transfer_ring->words_per_buffer() : _read_buffer_words;
+                if (_chunk_words > 0) {
+                    maximum_read_words = std::min(maximum_read_words, _chunk_words);
+                }
+                auto remaining_words = number_of_words;
+                do {
+                    auto number_of_read_words = std::min(remaining_words, maximum_read_words);
+                    number_of_read_words -= number_of_read_words % _read_granularity_words;
+                    auto block_read = _block_size > 0;
+                    if (number_of_read_words == 0) {
+                        // the words which do not fill a block are read once the board has more, or with a regular
+                        // pipe-out read if the board still has less than a block after an idle poll
+                        if (remaining_words < number_of_words) {
+                            break;
+                        }
+                        if (!_partial_block_pending) {
+                            _partial_block_pending = true;
+                            return 0;
+                        }
+                        number_of_read_words = remaining_words;
+                        block_read = false;
+                    }
+                    auto data = events_data;
+                    if (_transfer_ring) {
+                        data = _transfer_ring->writable();
+                        if (!data) {
+                            return 0;
+                        }
+                    }
+                    const auto read_begin = std::chrono::steady_clock::now();
+                    if (block_read) {
+                        _front_panel->read_from_block_pipe_out(0xa0, _block_size, number_of_read_words * 4, data);
+                    } else {
+                        _front_panel->read_from_pipe_out(0xa0, number_of_read_words * 4, data);
+                    }
+                    const auto read_time = std::chrono::steady_clock::now();
+                    _partial_block_pending = false;
+                    _counters.count_read(number_of_read_words, read_time - read_begin);
+                    if (_transfer_ring) {
+                        _transfer_ring->commit(number_of_read_words, read_time);
+                    } else {
+                        handle_words(events_data, number_of_read_words, read_time);
+                    }
+                    remaining_words -= number_of_read_words;
+                } while (_chunk_words > 0 && remaining_words > 0
+                         && _acquisition_running.load(std::memory_order_relaxed));
+            } else if (_front_panel->serial() != _serial) {
+                throw sepia::device_disconnected("Opal Kelly ATIS");
+            } else {
+                // let the decoding thread drain the spill file and run the filters while the board is idle
+                if (_idle_handover || _spilling.load(std::memory_order_acquire)) {
+                    if (!_transfer_ring) {
+                        handle_words(events_data, 0, std::chrono::steady_clock::now());
+                    } else if (_transfer_ring->writable()) {
+                        _transfer_ring->commit(0, std::chrono::steady_clock::now());
+                    }
+                }
+                handle_idle();
+            }
+            return number_of_words;
+        }
+
+        /// open_settings allows changes to the biases and the selection.
+        void open_settings() {
+            _front_panel->set_wire_in_value(0x00, 1 << 5, 1 << 5);
+            _front_panel->update_wire_ins();
+        }
+
+        /// close_settings applies the changes to the biases and the selection.
+        void close_settings() {
+            _front_panel->set_wire_in_value(0x00, 0, 1 << 5);
+            _front_panel->update_wire_ins();
+        }
+
+        /// write_bias programs a digital-to-analog converter, and records the value sent to the board.
+        /// The settings must be open, and the biases are applied by the trigger-in 6.
+        void write_bias(const std::unordered_map<std::string, uint32_t>& setting, uint32_t value) {
+            _front_panel->set_wire_in_value(0x01, value);
+            _front_panel->set_wire_in_value(0x02, setting.at("tension"));
+            _front_panel->set_wire_in_value(0x03, setting.at("address"));
+            _front_panel->update_wire_ins();
+            _front_panel->activate_trigger_in(0x40, 1);
+            _bias_values[setting.at("address")] = value;
+        }
+
+        /// write_selection sends the selection packs which differ from the board's, and applies them.
+        /// The settings must be open.
+        void write_selection(const std::vector<uint16_t>& packs) {
+            if (packs == _selection_packs) {
+                return;
+            }
+            for (std::size_t index = 0; index < packs.size(); ++index) {
+                if (_selection_packs.size() != packs.size() || _selection_packs[index] != packs[index]) {
+                    _front_panel->set_wire_in_value(0x01, packs[index]);
+                    _front_panel->set_wire_in_value(0x02, static_cast<uint32_t>(index));
+                    _front_panel->update_wire_ins();
+                    _front_panel->activate_trigger_in(0x40, 3);
+                }
+            }
+            _selection_packs = packs;
+            _front_panel->activate_trigger_in(0x40, 4);
+        }
+
+        /// write_selection_mode defines wether the pixels outside the selection are disabled, or wether the ones
+        /// inside are, and which part of the pixels the selection is applied to.
+        /// Nothing is sent if the mode is the one last sent to the board.
+        void write_selection_mode(bool selection_is_region_of_interest, const std::string& apply_selection_to) {
+            const auto selection_mode = static_cast<uint32_t>(
+                (selection_is_region_of_interest ? 1 << 9 : 0)
+                | (apply_selection_to == "change_detection"
+                           || apply_selection_to == "change_detection_and_exposure_measurement" ?
+                       1 << 4 :
+                       0)
+                | (apply_selection_to == "exposure_measurement"
+                           || apply_selection_to == "change_detection_and_exposure_measurement" ?
+                       1 << 3 :
+                       0));
+            if (_selection_mode_written && selection_mode == _selection_mode) {
+                return;
+            }
+            _front_panel->set_wire_in_value(0x00, selection_mode, (1 << 9) | (1 << 4) | (1 << 3));
+            _front_panel->update_wire_ins();
+            _selection_mode = selection_mode;
+            _selection_mode_written = true;
+        }
+
+        /// stop joins the acquisition threads.
+        /// It must be called at the beginning of the derived class destructor.
+        void stop() {
+            _acquisition_running.store(false, std::memory_order_relaxed);
+            if (_transfer_ring) {
+                _transfer_ring->close();
+            }
+            if (_acquisition_loop.joinable()) {
+                _acquisition_loop.join();
+            }
+            if (_decoding_loop.joinable()) {
+                _decoding_loop.join();
+            }
+        }
+
+        /// handle_drop calls the drop handler, if any.
+        void handle_drop(const events_dropped& drop) {
+            std::lock_guard<std::mutex> lock(_drop_mutex);
+            if (_handle_drop) {
+                _handle_drop(drop);
+            }
+        }
+
+        /// stop_with_exception stops the acquisition threads and forwards the exception to the handler.
+        void stop_with_exception(std::exception_ptr exception) {
+            _acquisition_running.store(false, std::memory_order_relaxed);
+            if (_transfer_ring) {
+                _transfer_ring->close();
+            }
+            handle_acquisition_exception(exception);
+        }
+
+        std::unique_ptr<sepia::parameter> _parameter;
+        std::atomic_bool _acquisition_running;
+        std::unique_ptr<polling_scheduler> _polling_scheduler;
+        std::unique_ptr<batched_front_panel> _front_panel;
+        std::string _serial;
+        std::unique_ptr<transfer_ring> _transfer_ring;
+        bool _huge_pages;
+        std::size_t _read_buffer_words;
+        std::size_t _chunk_words;
+        std::size_t _block_size;
+        bool _partial_block_pending;
+        std::size_t _read_granularity_words;
+        std::unique_ptr<aligned_buffer> _read_buffer;
+        overflow_policy _overflow_policy;
+        bool _idle_handover;
+        std::atomic_bool _spilling;
+        std::array<int, 3> _thread_cpus;
+        std::string _scheduling_policy;
+        int _scheduling_priority;
+        placement_report _placement;
+        mutable std::mutex _placement_mutex;
+        std::thread _acquisition_loop;
+        std::thread _decoding_loop;
+        uint64_t _t_offset;
+        acquisition_counters _counters;
+        clock_model _host_clock;
+        startup_report _startup;
+        std::mutex _configuration_mutex;
+        std::function<void(const events_dropped&)> _handle_drop;
+        std::mutex _drop_mutex;
+        std::unordered_map<uint32_t, uint32_t> _bias_values;
+        std::vector<uint16_t> _selection_packs;
+        uint32_t _selection_mode;
+        bool _selection_mode_written;
+    };
+
+    /// span represents a contiguous sequence of events.
+    template <typename Event>
+    class span {
+        public:
+        span() : _data(nullptr), _size(0) {}
+        span(Event* data, std::size_t size) : _data(data), _size(size) {}
+
+        /// data returns a pointer to the first event.
+        Event* data() const {
+            return _data;
+        }
+
+        /// size returns the number of events.
+        std::size_t size() const {
+            return _size;
+        }
+
+        /// empty returns true if the span contains no events.
+        bool empty() const {
+            return _size == 0;
+        }
+
+        /// begin returns an iterator to the first event.
+        Event* begin() const {
+            return _data;
+        }
+
+        /// end returns an iterator past the last event.
+        Event* end() const {
+            return _data + _size;
+        }
+
+        /// operator[] returns the event at the given index.
+        Event& operator[](std::size_t index) const {
+            return _data[index];
+        }
+
+        protected:
+        Event* _data;
+        std::size_t _size;
+    };
+
+    /// batch_fifo is a single-producer single-consumer circular FIFO exchanging contiguous spans of events.
+    /// The producer writes events in place and publishes them in bulk, and the consumer reads them in bulk.
+    /// The storage is not initialised, so that creating a large FIFO does not touch its pages.
+    /// If huge_pages is true, the storage is backed by huge pages where the system supports it.
+    template <typename Event>
+    class batch_fifo {
+        static_assert(
+            std::is_trivially_copyable<Event>::value,
+            "the events of a batch_fifo must be trivially copyable");
+
+        public:
+        batch_fifo(std::size_t size, bool huge_pages = false) :
+            _storage(size * sizeof(Event), huge_pages),
+            _events(reinterpret_cast<Event*>(_storage.data())),
+            _size(size),
+            _head(0),
+            _tail(0) {}
+        batch_fifo(const batch_fifo&) = delete;
+        batch_fifo(batch_fifo&&) = delete;
+        batch_fifo& operator=(const batch_fifo&) = delete;
+        batch_fifo& operator=(batch_fifo&&) = delete;
+        virtual ~batch_fifo() {}
+
+        /// writable returns the contiguous free space after the last published event.
+        /// It must only be called by the producer, and is empty if the FIFO is full.
+        span<Event> writable() {
+            const auto tail = _tail.load(std::memory_order_relaxed);
+            const auto head = _head.load(std::memory_order_acquire);
+            if (tail < head) {
+                return span<Event>(_events + tail, head - tail - 1);
+            }
+            return span<Event>(_events + tail, _size - tail - (head == 0 ? 1 : 0));
+        }
+
+        /// commit publishes the first size events of the span returned by writable.
+        void commit(std::size_t size) {
+            _tail.store((_tail.load(std::memory_order_relaxed) + size) % _size, std::memory_order_release);
+        }
+
+        /// push copies events to the FIFO and publishes them.
+        /// If the events could not be inserted (FIFO full), false is returned and no event is published.
+        bool push(span<const Event> events) {
+            const auto head = _head.load(std::memory_order_acquire);
+            const auto tail = _tail.load(std::memory_order_relaxed);
+            if ((head + _size - tail - 1) % _size < events.size()) {
+                return false;
+            }
+            const auto first_size = std::min(events.size(), _size - tail);
+            std::copy(events.begin(), events.begin() + first_size, _events + tail);
+            std::copy(events.begin() + first_size, events.end(), _events);
+            _tail.store((tail + events.size()) % _size, std::memory_order_release);
+            return true;
+        }
+
+        /// readable returns the contiguous published events after the last released event.
+        /// It must only be called by the consumer, and is empty if the FIFO is empty.
+        span<const Event> readable() const {
+            const auto head = _head.load(std::memory_order_relaxed);
+            const auto tail = _tail.load(std::memory_order_acquire);
+            return span<const Event>(_events + head, (tail < head ? _size : tail) - head);
+        }
+
+        /// release frees the first size events of the span returned by readable.
+        void release(std::size_t size) {
+            _head.store((_head.load(std::memory_order_relaxed) + size) % _size, std::memory_order_release);
+        }
+
+        /// occupancy returns the number of published events which were not released yet.
+        /// It can be called from any thread.
+        std::size_t occupancy() const {
+            return (_tail.load(std::memory_order_acquire) + _size - _head.load(std::memory_order_acquire)) % _size;
+        }
+
+        /// capacity returns the number of events that the storage holds.
+        /// One slot is kept free to distinguish a full FIFO from an empty one.
+        std::size_t capacity() const {
+            return _size;
+        }
+
+        /// allocated_size returns the number of bytes allocated for the events.
+        std::size_t allocated_size() const {
+            return _storage.size();
+        }
+
+        /// resident_size returns the number of bytes of the storage backed by physical memory.
+        /// It can be called from any thread.
+        std::size_t resident_size() const {
+            return _storage.resident_size();
+        }
+
+        protected:
+        aligned_buffer _storage;
+        Event* const _events;
+        const std::size_t _size;
+        std::atomic<std::size_t> _head;
+        std::atomic<std::size_t> _tail;
+    };
+
+    /// pixel_index returns the index of an event's pixel in a dense row-major table.
+    template <typename Event>
+    inline std::size_t pixel_index(const Event& event) {
+        return static_cast<std::size_t>(event.x) + static_cast<std::size_t>(event.y) * camera::width();
+    }
+
+    /// is_threshold_crossing returns true if an ATIS event is a threshold crossing.
+    inline bool is_threshold_crossing(const sepia::atis_event& event) {
+        return event.is_threshold_crossing;
+    }
+
+    /// is_threshold_crossing returns false, since DVS events are change detections.
+    inline bool is_threshold_crossing(const sepia::dvs_event&) {
+        return false;
+    }
+
+    /// is_second_threshold_crossing returns true if an ATIS threshold crossing ends an exposure measurement.
+    inline bool is_second_threshold_crossing(const sepia::atis_event& event) {
+        return event.polarity;
+    }
+
+    /// is_second_threshold_crossing is never called with DVS events, and returns false.
+    inline bool is_second_threshold_crossing(const sepia::dvs_event&) {
+        return false;
+    }
+
+    /// is_threshold_crossing returns true if a compact ATIS event is a threshold crossing.
+    inline bool is_threshold_crossing(const compact_atis_event& event) {
+        return event.is_threshold_crossing == 1;
+    }
+
+    /// is_second_threshold_crossing returns true if a compact ATIS threshold crossing ends an exposure measurement.
+    inline bool is_second_threshold_crossing(const compact_atis_event& event) {
+        return event.polarity == 1;
+    }
+
+    /// filter_chain applies filters in sequence to the decoded events, before they are published to the host FIFO.
+    /// A filter is a functor which removes events in place from an array and returns the number of kept events,
+    /// with the signature std::size_t(Event* events, std::size_t number_of_events), where Event is the decode
+    /// mode's event type.
+    /// The filters are template parameters, hence an empty chain compiles to nothing.
+    template <typename... Filters>
+    class filter_chain;
+
+    /// filter_chain<> keeps every event.
+    template <>
+    class filter_chain<> {
+        public:
+        template <typename Event>
+        std::size_t operator()(Event*, std::size_t number_of_events) {
+            return number_of_events;
+        }
+    };
+
+    template <typename Filter, typename... Filters>
+    class filter_chain<Filter, Filters...> {
+        public:
+        filter_chain(Filter filter, Filters... filters) :
+            _filter(std::forward<Filter>(filter)),
+            _filters(std::forward<Filters>(filters)...) {}
+        filter_chain(const filter_chain&) = default;
+        filter_chain(filter_chain&&) = default;
+        filter_chain& operator=(const filter_chain&) = default;
+        filter_chain& operator=(filter_chain&&) = default;
+        virtual ~filter_chain() {}
+
+        /// operator() applies the first filter, then the others to the kept events.
+        template <typename Event>
+        std::size_t operator()(Event* events, std::size_t number_of_events) {
+            return _filters(events, _filter(events, number_of_events));
+        }
+
+        protected:
+        Filter _filter;
+        filter_chain<Filters...> _filters;
+    };
+
+    /// make_filter_chain creates a filter chain from filters.
+    template <typename... Filters>
+    filter_chain<Filters...> make_filter_chain(Filters... filters) {
+        return filter_chain<Filters...>(std::forward<Filters>(filters)...);
+    }
+
+    /// timestamp_table stores a timestamp per pixel as a 32-bit offset from a rolling base, which halves the filters'
+    /// cache footprint. A zero offset marks an empty entry. Once an offset reaches 2^31 microseconds (about 36
+    /// minutes), the base moves to the current timestamp and the entries which precede it are cleared, hence the
+    /// durations compared with the entries must be smaller than 2^31 microseconds.
+    class timestamp_table {
+        public:
+        timestamp_table(std::size_t size) : _base(0), _offsets(size, 0) {}
+        timestamp_table(const timestamp_table&) = default;
+        timestamp_table(timestamp_table&&) = default;
+        timestamp_table& operator=(const timestamp_table&) = default;
+        timestamp_table& operator=(timestamp_table&&) = default;
+        virtual ~timestamp_table() {}
+
+        /// maximum_duration returns the largest duration which can be added to an offset.
+        static constexpr uint64_t maximum_duration() {
+            return (static_cast<uint64_t>(1) << 31) - 2;
+        }
+
+        /// offset returns the timestamp relative to the base, after moving the base if needed.
+        /// Timestamps older than the base are mapped to zero.
+        uint32_t offset(uint64_t t) {
+            if (t < _base) {
+                return 0;
+            }
+            if (t - _base > maximum_duration()) {
+                const auto shift = t - _base;
+                for (auto& entry : _offsets) {
+                    entry = entry > shift ? static_cast<uint32_t>(entry - shift) : 0;
+                }
+                _base = t;
+            }
+            return static_cast<uint32_t>(t - _base);
+        }
+
+        /// operator[] returns the offset stored for a pixel.
+        uint32_t& operator[](std::size_t index) {
+            return _offsets[index];
+        }
+
+        protected:
+        uint64_t _base;
+        std::vector<uint32_t> _offsets;
+    };
+
+    /// refractory_filter removes the change detections which follow the previous kept change detection of the same
+    /// pixel by less than the refractory period. Exposure measurements are kept.
+    class refractory_filter {
+        public:
+        refractory_filter(std::chrono::microseconds refractory_period) :
+            _refractory_period(static_cast<uint32_t>(refractory_period.count())),
+            _expirations(static_cast<std::size_t>(camera::width()) * camera::height()) {
+            if (refractory_period.count() < 0
+                || static_cast<uint64_t>(refractory_period.count()) > timestamp_table::maximum_duration()) {
+                throw std::runtime_error("the refractory period must be smaller than 2^31 microseconds");
+            }
+        }
+        refractory_filter(const refractory_filter&) = default;
+        refractory_filter(refractory_filter&&) = default;
+        refractory_filter& operator=(const refractory_filter&) = default;
+        refractory_filter& operator=(refractory_filter&&) = default;
+        virtual ~refractory_filter() {}
+
+        /// operator() removes the events in the refractory period.
+        template <typename Event>
+        std::size_t operator()(Event* events, std::size_t number_of_events) {
+            std::size_t number_of_kept_events = 0;
+            for (std::size_t index = 0; index < number_of_events; ++index) {
+                const auto event = events[index];
+                if (!is_threshold_crossing(event)) {
+                    const auto t = _expirations.offset(event.t);
+                    auto& expiration = _expirations[pixel_index(event)];
+                    if (t < expiration) {
+                        continue;
+                    }
+                    expiration = t + _refractory_period;
+                }
+                events[number_of_kept_events] = event;
+                ++number_of_kept_events;
+            }
+            return number_of_kept_events;
+        }
+
+        protected:
+        const uint32_t _refractory_period;
+        timestamp_table _expirations;
+    };
+
+    /// background_activity_filter removes the change detections which are not supported by a change detection of a
+    /// neighbouring pixel (8-neighbourhood) in the correlation window. Exposure measurements are kept.
+    /// Each event writes its support to its neighbours, so that the test is a single read. The table has a one-pixel
+    /// margin, so that the border pixels need no bounds checks.
+    class background_activity_filter {
+        public:
+        background_activity_filter(std::chrono::microseconds correlation_window) :
+            _correlation_window(static_cast<uint32_t>(correlation_window.count())),
+            _expirations((static_cast<std::size_t>(camera::width()) + 2) * (camera::height() + 2)) {
+            if (correlation_window.count() < 0
+                || static_cast<uint64_t>(correlation_window.count()) >= timestamp_table::maximum_duration()) {
+                throw std::runtime_error("the correlation window must be smaller than 2^31 microseconds");
+            }
+        }
+        background_activity_filter(const background_activity_filter&) = default;
+        background_activity_filter(background_activity_filter&&) = default;
+        background_activity_filter& operator=(const background_activity_filter&) = default;
+        background_activity_filter& operator=(background_activity_filter&&) = default;
+        virtual ~background_activity_filter() {}
+
+        /// operator() removes the unsupported events.
+        template <typename Event>
+        std::size_t operator()(Event* events, std::size_t number_of_events) {
+            const std::size_t stride = camera::width() + 2;
+            std::size_t number_of_kept_events = 0;
+            for (std::size_t index = 0; index < number_of_events; ++index) {
+                const auto event = events[index];
+                if (!is_threshold_crossing(event)) {
+                    const auto center =
+                        static_cast<std::size_t>(event.x) + 1 + (static_cast<std::size_t>(event.y) + 1) * stride;
+                    const auto t = _expirations.offset(event.t);
+                    const auto supported = t < _expirations[center];
+                    const auto expiration = t + _correlation_window + 1;
+                    for (const auto row : {center - stride, center + stride}) {
+                        _expirations[row - 1] = expiration;
+                        _expirations[row] = expiration;
+                        _expirations[row + 1] = expiration;
+                    }
+                    _expirations[center - 1] = expiration;
+                    _expirations[center + 1] = expiration;
+                    if (!supported) {
+                        continue;
+                    }
+                }
+                events[number_of_kept_events] = event;
+                ++number_of_kept_events;
+            }
+            return number_of_kept_events;
+        }
+
+        protected:
+        const uint32_t _correlation_window;
+        timestamp_table _expirations;
+    };
+
+    /// hot_pixel_filter counts the events of each pixel during a calibration window starting with the first event,
+    /// then removes every event of the pixels whose count exceeds the given multiple of the mean count of active
+    /// pixels. The events of the calibration window are kept.
+    class hot_pixel_filter {
+        public:
+        hot_pixel_filter(std::chrono::microseconds calibration_duration, double ratio) :
+            _calibration_duration(static_cast<uint64_t>(calibration_duration.count())),
+            _ratio(ratio),
+            _calibrating(true),
+            _calibration_end(0),
+            _counts(static_cast<std::size_t>(camera::width()) * camera::height(), 0),
+            _mask(static_cast<std::size_t>(camera::width()) * camera::height(), 0) {}
+        hot_pixel_filter(const hot_pixel_filter&) = default;
+        hot_pixel_filter(hot_pixel_filter&&) = default;
+        hot_pixel_filter& operator=(const hot_pixel_filter&) = default;
+        hot_pixel_filter& operator=(hot_pixel_filter&&) = default;
+        virtual ~hot_pixel_filter() {}
+
+        /// operator() counts the events during the calibration window, and removes the hot pixels' events after it.
+        template <typename Event>
+        std::size_t operator()(Event* events, std::size_t number_of_events) {
+            std::size_t index = 0;
+            if (_calibrating) {
+                for (; index < number_of_events; ++index) {
+                    const auto event = events[index];
+                    if (_calibration_end == 0) {
+                        _calibration_end = event.t + _calibration_duration + 1;
+                    }
+                    if (event.t >= _calibration_end) {
+                        calibrate();
+                        break;
+                    }
+                    ++_counts[pixel_index(event)];
+                }
+                if (_calibrating) {
+                    return number_of_events;
+                }
+            }
+            auto number_of_kept_events = index;
+            for (; index < number_of_events; ++index) {
+                const auto event = events[index];
+                if (_mask[pixel_index(event)] == 0) {
+                    events[number_of_kept_events] = event;
+                    ++number_of_kept_events;
+                }
+            }
+            return number_of_kept_events;
+        }
+
+        /// hot_pixels returns the number of masked pixels.
+        /// It must be called from the thread applying the filter (for instance, before the camera is created).
+        std::size_t hot_pixels() const {
+            return static_cast<std::size_t>(std::count(_mask.begin(), _mask.end(), 1));
+        }
+
+        protected:
+        /// calibrate computes the mask from the counts.
+        void calibrate() {
+            uint64_t total = 0;
+            std::size_t active_pixels = 0;
+            for (const auto count : _counts) {
+                total += count;
+                if (count > 0) {
+                    ++active_pixels;
+                }
+            }
+            if (active_pixels > 0) {
+                const auto threshold = _ratio * static_cast<double>(total) / active_pixels;
+                for (std::size_t index = 0; index < _counts.size(); ++index) {
+                    _mask[index] = static_cast<double>(_counts[index]) > threshold ? 1 : 0;
+                }
+            }
+            _calibrating = false;
+        }
+
+        const uint64_t _calibration_duration;
+        const double _ratio;
+        bool _calibrating;
+        uint64_t _calibration_end;
+        std::vector<uint32_t> _counts;
+        std::vector<uint8_t> _mask;
+    };
+
+    /// exposure_measurement is a pair of threshold crossings of the same pixel.
+    /// t is the timestamp of the second crossing, and exposure the time between the crossings, in microseconds.
+    /// The exposure is inversely proportional to the pixel's light intensity.
+    struct exposure_measurement {
+        uint64_t t;
+        uint64_t exposure;
+        uint16_t x;
+        uint16_t y;
+    };
+
+    /// exposure_pairing is a filter which pairs the threshold crossings of each pixel into exposure measurements.
+    /// The threshold crossings are removed from the events (and counted as filtered events), and the change
+    /// detections pass through. The exposures handler is called by the decoding thread, once per decoded chunk,
+    /// with the chunk's measurements, hence it must return quickly. A second crossing without a first is dropped.
+    template <typename HandleExposures>
+    class exposure_pairing {
+        public:
+        exposure_pairing(HandleExposures handle_exposures) :
+            _handle_exposures(std::forward<HandleExposures>(handle_exposures)),
+            _first_ts(static_cast<std::size_t>(camera::width()) * camera::height()) {}
+        exposure_pairing(const exposure_pairing&) = default;
+        exposure_pairing(exposure_pairing&&) = default;
+        exposure_pairing& operator=(const exposure_pairing&) = default;
+        exposure_pairing& operator=(exposure_pairing&&) = default;
+        virtual ~exposure_pairing() {}
+
+        /// operator() removes the threshold crossings, and calls the exposures handler with the completed pairs.
+        template <typename Event>
+        std::size_t operator()(Event* events, std::size_t number_of_events) {
+            std::size_t number_of_kept_events = 0;
+            for (std::size_t index = 0; index < number_of_events; ++index) {
+                const auto event = events[index];
+                if (is_threshold_crossing(event)) {
+                    const auto t = _first_ts.offset(event.t);
+                    auto& first_t = _first_ts[pixel_index(event)];
+                    if (!is_second_threshold_crossing(event)) {
+                        first_t = t + 1;
+                    } else if (first_t > 0) {
+                        _exposures.push_back(exposure_measurement{
+                            event.t,
+                            t + 1 - first_t,
+                            static_cast<uint16_t>(event.x),
+                            static_cast<uint16_t>(event.y)});
+                        first_t = 0;
+                    }
+                } else {
+                    events[number_of_kept_events] = event;
+                    ++number_of_kept_events;
+                }
+            }
+            if (!_exposures.empty()) {
+                _handle_exposures(span<const exposure_measurement>(_exposures.data(), _exposures.size()));
+                _exposures.clear();
+            }
+            return number_of_kept_events;
+        }
+
+        protected:
+        HandleExposures _handle_exposures;
+        timestamp_table _first_ts;
+        std::vector<exposure_measurement> _exposures;
+    };
+
+    /// make_exposure_pairing creates an exposure pairing filter from a functor.
+    template <typename HandleExposures>
+    exposure_pairing<HandleExposures> make_exposure_pairing(HandleExposures handle_exposures) {
+        return exposure_pairing<HandleExposures>(std::forward<HandleExposures>(handle_exposures));
+    }
+
+    /// frame is an immutable snapshot of the dense representations built by a frame accumulator.
+    /// Each plane is a row-major table of camera::width() * camera::height() values, indexed like pixel_index.
+    ///     - t is the timestamp of the last event accumulated before the snapshot
+    ///     - counts holds the change detections of each pixel since the previous snapshot
+    ///     - ts holds the timestamp of each pixel's last change detection, or no_event() if it has none
+    ///     - time_surface holds exp((ts - t) / decay) for each pixel, and 0 for the pixels without change detections
+    ///     - exposures holds each pixel's last exposure measurement in microseconds, or 0 if it has none (the grey
+    ///       level is inversely proportional to the exposure)
+    struct frame {
+        /// no_event is the timestamp of the pixels without change detections.
+        static constexpr uint64_t no_event() {
+            return std::numeric_limits<uint64_t>::max();
+        }
+
+        uint64_t t;
+        std::vector<uint32_t> counts;
+        std::vector<uint64_t> ts;
+        std::vector<float> time_surface;
+        std::vector<uint32_t> exposures;
+    };
+
+    /// frame_accumulator is a filter which keeps every event, and accumulates them into dense planes.
+    /// A snapshot of the planes is published whenever an event timestamp reaches the next multiple of the period
+    /// (0 disables periodic snapshots), and at the next decoded chunk or idle poll after request_snapshot is called.
+    /// While the board is idle, the camera calls the filters without events, and a snapshot is published once the
+    /// period has elapsed on the host clock since the previous one, with the timestamp of the last event. The time
+    /// surface decays with the given time constant (0 yields 1 for every pixel with a change detection).
+    /// The snapshots are shared immutable frames, hence any number of readers can hold them without copies. A
+    /// published frame is recycled once the last reader releases it, so that two frames suffice at steady state.
+    /// Copies of an accumulator share their state, so that a copy kept by the user reads the snapshots of the copy
+    /// moved into the camera's filter chain. Threshold crossings must reach the accumulator for exposures to be
+    /// measured, hence it must precede an exposure pairing filter in the chain.
+    class frame_accumulator {
+        public:
+        frame_accumulator(std::chrono::microseconds period, std::chrono::microseconds decay) :
+            _state(std::make_shared<state>(
+                static_cast<uint64_t>(period.count()),
+                static_cast<float>(decay.count()),
+                static_cast<std::size_t>(camera::width()) * camera::height())) {}
+        frame_accumulator(const frame_accumulator&) = default;
+        frame_accumulator(frame_accumulator&&) = default;
+        frame_accumulator& operator=(const frame_accumulator&) = default;
+        frame_accumulator& operator=(frame_accumulator&&) = default;
+        virtual ~frame_accumulator() {}
+
+        /// operator() accumulates the events and publishes the due snapshots.
+        template <typename Event>
+        std::size_t operator()(Event* events, std::size_t number_of_events) {
+            auto& current_state = *_state;
+            if (current_state.requested.exchange(false, std::memory_order_acquire)) {
+                publish(current_state);
+            } else if (
+                number_of_events == 0 && current_state.period != frame::no_event()
+                && std::chrono::steady_clock::now() - current_state.published_at
+                       >= std::chrono::microseconds(current_state.period)) {
+                publish(current_state);
+            }
+            for (std::size_t index = 0; index < number_of_events; ++index) {
+                const auto event = events[index];
+                if (event.t >= current_state.next_t) {
+                    publish(current_state);
+                    current_state.next_t = event.t - event.t % current_state.period + current_state.period;
+                }
+                const auto pixel = pixel_index(event);
+                if (is_threshold_crossing(event)) {
+                    auto& first_t = current_state.first_ts[pixel];
+                    if (!is_second_threshold_crossing(event)) {
+                        first_t = event.t + 1;
+                    } else if (first_t > 0) {
+                        current_state.exposures[pixel] = static_cast<uint32_t>(std::min(
+                            event.t + 1 - first_t, static_cast<uint64_t>(std::numeric_limits<uint32_t>::max())));
+                        first_t = 0;
+                    }
+                } else {
+                    ++current_state.counts[pixel];
+                    current_state.ts[pixel] = event.t;
+                }
+                current_state.t = event.t;
+            }
+            return number_of_events;
+        }
+
+        /// snapshot returns the last published frame, or nullptr if no frame was published yet.
+        /// It can be called from any thread.
+        std::shared_ptr<const frame> snapshot() const {
+            return std::atomic_load(&_state->latest);
+        }
+
+        /// request_snapshot publishes a frame at the next decoded chunk or idle poll, regardless of the period.
+        /// It can be called from any thread.
+        void request_snapshot() {
+            _state->requested.store(true, std::memory_order_release);
+        }
+
+        protected:
+        /// state holds the working planes, written by the decoding thread only, and the published frames.
+        struct state {
+            state(uint64_t period, float decay, std::size_t size) :
+                period(period == 0 ? frame::no_event() : period),
+                decay(decay),
+                next_t(period == 0 ? frame::no_event() : period),
+                t(0),
+                counts(size, 0),
+                ts(size, frame::no_event()),
+                exposures(size, 0),
+                first_ts(size, 0),
+                published_at(std::chrono::steady_clock::now()),
+                requested(false) {}
+
+            const uint64_t period;
+            const float decay;
+            uint64_t next_t;
+            uint64_t t;
+            std::vector<uint32_t> counts;
+            std::vector<uint64_t> ts;
+            std::vector<uint32_t> exposures;
+            std::vector<uint64_t> first_ts;
+            std::vector<std::shared_ptr<frame>> frames;
+            std::shared_ptr<const frame> latest;
+            std::chrono::steady_clock::time_point published_at;
+            std::atomic_bool requested;
+        };
+
+        /// publish copies the working planes to a free frame, publishes it, and resets the counts.
+        /// A frame is free when the accumulator holds its only reference: it is neither the latest frame, which
+        /// readers may still load, nor held by a reader. The use count is read with relaxed ordering, hence an
+        /// acquire fence orders the readers' last accesses before the frame is overwritten.
+        static void publish(state& current_state) {
+            std::shared_ptr<frame> free_frame;
+            for (const auto& candidate : current_state.frames) {
+                if (candidate.use_count() == 1) {
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    free_frame = candidate;
+                    break;
+                }
+            }
+            if (!free_frame) {
+                free_frame = std::make_shared<frame>();
+                free_frame->time_surface.resize(current_state.ts.size());
+                current_state.frames.push_back(free_frame);
+            }
+            free_frame->t = current_state.t;
+            free_frame->counts = current_state.counts;
+            free_frame->ts = current_state.ts;
+            free_frame->exposures = current_state.exposures;
+            const auto inverse_decay = current_state.decay > 0.0f ? -1.0f / current_state.decay : 0.0f;
+            for (std::size_t index = 0; index < current_state.ts.size(); ++index) {
+                const auto pixel_t = current_state.ts[index];
+                free_frame->time_surface[index] =
+                    pixel_t == frame::no_event()
+                        ? 0.0f
+                        : std::exp(static_cast<float>(current_state.t - pixel_t) * inverse_decay);
+            }
+            std::atomic_store(&current_state.latest, std::shared_ptr<const frame>(free_frame));
+            std::fill(current_state.counts.begin(), current_state.counts.end(), 0);
+            current_state.published_at = std::chrono::steady_clock::now();
+        }
+
+        std::shared_ptr<state> _state;
+    };
+
+    /// decoding_camera decodes the words read from an ATIS to a host FIFO of events, whose type is given by the
+    /// decode mode. The filters are applied by the decoding thread, so that removed events never reach the host FIFO.
+    /// The derived classes consume the FIFO. They must call start (or start_dispatching if they own a dispatching
+    /// thread) at the end of their constructor, and stop at the beginning of their destructor.
+    template <typename Filter, typename Mode>
+    class decoding_camera : public camera {
+        public:
+        decoding_camera(
+            std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter,
+            std::size_t fifo_size,
+            std::string serial,
+            std::chrono::milliseconds sleep_duration,
+            std::unique_ptr<front_panel> opened_front_panel,
+            Filter filter) :
+            camera(std::move(unvalidated_parameter), serial, sleep_duration, std::move(opened_front_panel)),
+            _filter(std::forward<Filter>(filter)),
+            _fifo(fifo_size, _huge_pages),
+            _discard_requested(false),
+            _dropped(false),
+            _overflow_episode(false) {
+            if (_overflow_policy == overflow_policy::spill) {
+                _spill_ring = sepia::make_unique<spill_ring>(
+                    _parameter->get_string({"acquisition", "overflow", "spill_filename"}),
+                    static_cast<std::size_t>(_parameter->get_number({"acquisition", "overflow", "spill_words"})));
+            }
+
+            // start the decoding workers if large reads are split across threads
+            const auto number_of_decoding_threads =
+                static_cast<std::size_t>(_parameter->get_number({"acquisition", "decoding", "threads"}));
+            if (number_of_decoding_threads > 1) {
+                _decoding_pool = sepia::make_unique<decoding_pool>(number_of_decoding_threads);
+            }
+            _parallel_decoding_words =
+                static_cast<std::size_t>(_parameter->get_number({"acquisition", "decoding", "minimum_words"}));
+
+            // the filters are called without events while the board is idle
+            _idle_handover = !std::is_same<Filter, filter_chain<>>::value;
+        }
+        decoding_camera(const decoding_camera&) = delete;
+        decoding_camera(decoding_camera&&) = delete;
+        decoding_camera& operator=(const decoding_camera&) = delete;
+        decoding_camera& operator=(decoding_camera&&) = delete;
+        virtual ~decoding_camera() {}
+
+        virtual memory_statistics memory() const override {
+            auto statistics = camera::memory();
+            statistics.allocated_fifo_bytes = _fifo.allocated_size();
+            statistics.resident_fifo_bytes = _fifo.resident_size();
+            return statistics;
+        }
+
+        protected:
+        /// handle_words decodes the words in place in the FIFO, and publishes the events of each decoded chunk.
+        /// If the FIFO is full, the overflow policy decides what happens to the remaining words.
+        /// handle_words is called without words to drain the spill file while the board is idle.
+        virtual void handle_words(
+            const uint8_t* data,
+            std::size_t number_of_words,
+            std::chrono::steady_clock::time_point read_time) override {
+            const auto is_read = number_of_words > 0;
+            uint64_t t = _t_offset;
+            _dropped = false;
+            if (_spill_ring) {
+                // the new words follow the spilled ones, so that the events are published in order
+                if (_spill_ring->size() > 0 && number_of_words > 0) {
+                    spill(data, number_of_words);
+                }
+                drain_spill(t);
+            }
+            if (_decoding_pool && number_of_words >= _parallel_decoding_words) {
+                handle_words_in_parallel(data, number_of_words, t);
+            }
+            while (number_of_words > 0) {
+                auto events = _fifo.writable();
+                if (events.empty()) {
+                    switch (_overflow_policy) {
+                        case overflow_policy::fail:
+                            throw std::runtime_error("Computer's FIFO overflow");
+                        case overflow_policy::drop_newest:
+                        case overflow_policy::drop_threshold_crossings: {
+                            std::size_t number_of_markers = 0;
+                            _counters.count_overflow_drop(
+                                scan<Mode>(data, number_of_words, number_of_markers), number_of_markers);
+                            _t_offset += 0x2000 * static_cast<uint64_t>(number_of_markers);
+                            number_of_words = 0;
+                            _dropped = true;
+                            continue;
+                        }
+                        case overflow_policy::spill:
+                            spill(data, number_of_words);
+                            continue;
+                        case overflow_policy::drop_oldest:
+                            _discard_requested.store(true, std::memory_order_release);
+                            _dropped = true;
+                            break;
+                        case overflow_policy::back_pressure:
+                            break;
+                    }
+                    events = wait_for_room();
+                    if (events.empty()) {
+                        return;
+                    }
+                }
+                const auto number_of_decoded_words = std::min(events.size(), number_of_words);
+                decode_and_publish(data, number_of_decoded_words, events, t);
+                data += 4 * number_of_decoded_words;
+                number_of_words -= number_of_decoded_words;
+            }
+            if (is_read) {
+                _counters.count_enqueue(std::chrono::steady_clock::now() - read_time);
+                _host_clock.update(std::max(t, _t_offset), read_time);
+            } else {
+                _filter(_fifo.writable().data(), 0);
+            }
+            handle_published();
+            if (_dropped && !_overflow_episode) {
+                _counters.count_overflow_episode();
+                handle_drop(events_dropped("Computer's FIFO overflow, events were dropped by the overflow policy"));
+            }
+            _overflow_episode = _dropped;
+        }
+
+        /// handle_published is called by the decoding thread once the events of a read are published.
+        virtual void handle_published() {}
+
+        /// dispatch calls handle_batch with the FIFO's readable spans until running is false, and sleeps while the
+        /// FIFO is empty. It is the body of the derived classes' dispatching thread.
+        template <typename HandleBatch>
+        void dispatch(
+            HandleBatch& handle_batch,
+            const std::atomic_bool& running,
+            std::chrono::milliseconds sleep_duration) {
+            place(thread_role::dispatching);
+            while (running.load(std::memory_order_relaxed)) {
+                discard_requested_events();
+                const auto events = _fifo.readable();
+                if (events.empty()) {
+                    std::this_thread::sleep_for(sleep_duration);
+                } else {
+                    const auto handler_begin = std::chrono::steady_clock::now();
+                    handle_batch(events);
+                    const auto handler_end = std::chrono::steady_clock::now();
+                    if (_host_clock.valid()) {
+                        _counters.count_handler(
+                            handler_begin - _host_clock.host_time(events[0].t), handler_end - handler_begin);
+                    }
+                    _fifo.release(events.size());
+                }
+            }
+        }
+
+        /// start_dispatching launches the acquisition threads after the derived class started its dispatching
+        /// thread. If they cannot be launched, the dispatching thread is stopped and joined before rethrowing, so
+        /// that the derived class's constructor does not throw with a joinable thread.
+        void start_dispatching(std::atomic_bool& running, std::thread& dispatching_loop) {
+            try {
+                start();
+            } catch (...) {
+                stop();
+                running.store(false, std::memory_order_relaxed);
+                dispatching_loop.join();
+                throw;
+            }
+        }
+
+        /// discard_requested_events is called by the consumer before reading the FIFO.
+        /// If the drop_oldest policy requested it, the oldest events are discarded until the FIFO is half full.
+        void discard_requested_events() {
+            if (_discard_requested.load(std::memory_order_acquire)) {
+                const auto half = _fifo.capacity() / 2;
+                for (auto occupancy = _fifo.occupancy(); occupancy > half; occupancy = _fifo.occupancy()) {
+                    const auto number_of_discarded_events = std::min(_fifo.readable().size(), occupancy - half);
+                    _counters.count_overflow_discard(number_of_discarded_events);
+                    _fifo.release(number_of_discarded_events);
+                }
+                _discard_requested.store(false, std::memory_order_release);
+            }
+        }
+
+        /// decode_and_publish decodes words to the span returned by the FIFO's writable, and publishes the events.
+        /// The span must have room for number_of_words events.
+        void decode_and_publish(
+            const uint8_t* data,
+            std::size_t number_of_words,
+            span<typename Mode::event> events,
+            uint64_t& t) {
+            const auto t_offset = _t_offset;
+            const auto decode_begin = std::chrono::steady_clock::now();
+            std::size_t number_of_discarded_events = 0;
+            const auto number_of_events =
+                decode<Mode>(data, number_of_words, _t_offset, events.data(), &number_of_discarded_events);
+            _counters.count_decode(
+                number_of_words,
+                number_of_events,
+                static_cast<std::size_t>((_t_offset - t_offset) >> 13),
+                number_of_discarded_events,
+                std::chrono::steady_clock::now() - decode_begin);
+            publish(events, number_of_events, t);
+        }
+
+        /// publish filters decoded events in place and commits them to the FIFO.
+        /// With the drop_threshold_crossings policy, threshold crossings are dropped while the FIFO is more than
+        /// half full. t is set to the largest published timestamp.
+        void publish(span<typename Mode::event> events, std::size_t number_of_events, uint64_t& t) {
+            auto number_of_kept_events = _filter(events.data(), number_of_events);
+            _counters.count_filter(number_of_events - number_of_kept_events);
+            if (_overflow_policy == overflow_policy::drop_threshold_crossings
+                && _fifo.occupancy() > _fifo.capacity() / 2) {
+                const auto number_of_filtered_events = number_of_kept_events;
+                number_of_kept_events = static_cast<std::size_t>(
+                    std::remove_if(
+                        events.data(),
+                        events.data() + number_of_filtered_events,
+                        [](const typename Mode::event& event) { return is_threshold_crossing(event); })
+                    - events.data());
+                if (number_of_kept_events < number_of_filtered_events) {
+                    _counters.count_overflow_drop(number_of_filtered_events - number_of_kept_events, 0);
+                    _dropped = true;
+                }
+            }
+            if (number_of_kept_events > 0) {
+                t = std::max(t, events[number_of_kept_events - 1].t);
+            }
+            _fifo.commit(number_of_kept_events);
+            _counters.count_push(number_of_kept_events, _fifo.occupancy());
+        }
+
+        /// spill stores words in the spill file, and advances data and number_of_words past them.
+        void spill(const uint8_t*& data, std::size_t& number_of_words) {
+            if (!_spill_ring->push(data, number_of_words)) {
+                throw std::runtime_error("Computer's FIFO and spill file overflow");
+            }
+            _counters.count_spill(number_of_words);
+            _spilling.store(true, std::memory_order_release);
+            data += 4 * number_of_words;
+            number_of_words = 0;
+        }
+
+        /// drain_spill decodes the spilled words while the FIFO has room.
+        void drain_spill(uint64_t& t) {
+            while (_spill_ring->size() > 0) {
+                const auto events = _fifo.writable();
+                if (events.empty()) {
+                    break;
+                }
+                std::size_t number_of_words = 0;
+                const auto data = _spill_ring->readable(number_of_words);
+                number_of_words = std::min(number_of_words, events.size());
+                decode_and_publish(data, number_of_words, events, t);
+                _spill_ring->release(number_of_words);
+            }
+            _spilling.store(_spill_ring->size() > 0, std::memory_order_release);
+        }
+
+        /// wait_for_room waits until the FIFO has free space, and returns it.
+        /// An empty span is returned if the acquisition is stopping.
+        span<typename Mode::event> wait_for_room() {
+            for (;;) {
+                const auto events = _fifo.writable();
+                if (!events.empty() || !_acquisition_running.load(std::memory_order_relaxed)) {
+                    return events;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+
+        /// handle_words_in_parallel splits the words into chunks decoded by the decoding pool.
+        /// A first pass counts the events and overflow markers of each chunk, and exclusive prefix sums give each
+        /// chunk its position in the FIFO and its t_offset base. The chunks are then decoded independently, filtered
+        /// and published in order, as many at a time as the FIFO's contiguous writable span holds.
+        /// data and number_of_words are advanced past the published chunks, and the remaining words (if the next chunk
+        /// does not fit before the end of the FIFO's storage) are left to the single-threaded path.
+        void handle_words_in_parallel(const uint8_t*& data, std::size_t& number_of_words, uint64_t& t) {
+            const auto number_of_chunks = _decoding_pool->size() * 4;
+            const auto words_per_chunk = (number_of_words + number_of_chunks - 1) / number_of_chunks;
+            const auto words = data;
+            const auto total_number_of_words = number_of_words;
+            auto chunk_words = [&](std::size_t chunk) {
+                return std::min(words_per_chunk, total_number_of_words - chunk * words_per_chunk);
+            };
+            const auto used_chunks = (total_number_of_words + words_per_chunk - 1) / words_per_chunk;
+            std::vector<std::size_t> chunks_events(used_chunks, 0);
+            std::vector<std::size_t> chunks_markers(used_chunks, 0);
+            std::vector<std::size_t> chunks_discarded_events(used_chunks, 0);
+            auto decode_begin = std::chrono::steady_clock::now();
+            _decoding_pool->run(used_chunks, [&](std::size_t chunk) {
+                chunks_events[chunk] =
+                    scan<Mode>(words + 4 * chunk * words_per_chunk, chunk_words(chunk), chunks_markers[chunk]);
+            });
+            std::vector<std::size_t> offsets(used_chunks + 1);
+            std::vector<uint64_t> t_offsets(used_chunks + 1);
+            std::size_t chunk = 0;
+            while (chunk < used_chunks) {
+                const auto events = _fifo.writable();
+                auto end = chunk;
+                offsets[chunk] = 0;
+                t_offsets[chunk] = _t_offset;
+                while (end < used_chunks && offsets[end] + chunks_events[end] <= events.size()) {
+                    offsets[end + 1] = offsets[end] + chunks_events[end];
+                    t_offsets[end + 1] = t_offsets[end] + 0x2000 * static_cast<uint64_t>(chunks_markers[end]);
+                    ++end;
+                }
+                if (end == chunk) {
+                    break;
+                }
+                _decoding_pool->run(end - chunk, [&](std::size_t index) {
+                    auto t_offset = t_offsets[chunk + index];
+                    decode<Mode>(
+                        words + 4 * (chunk + index) * words_per_chunk,
+                        chunk_words(chunk + index),
+                        t_offset,
+                        events.data() + offsets[chunk + index],
+                        &chunks_discarded_events[chunk + index]);
+                });
+                const auto number_of_decoded_words = std::min(end * words_per_chunk, total_number_of_words)
+                                                     - chunk * words_per_chunk;
+                const auto number_of_events = offsets[end];
+                _counters.count_decode(
+                    number_of_decoded_words,
+                    number_of_events,
+                    static_cast<std::size_t>((t_offsets[end] - _t_offset) >> 13),
+                    std::accumulate(
+                        chunks_discarded_events.begin() + chunk,
+                        chunks_discarded_events.begin() + end,
+                        static_cast<std::size_t>(0)),
+                    std::chrono::steady_clock::now() - decode_begin);
+                _t_offset = t_offsets[end];
+                publish(events, number_of_events, t);
+                data += 4 * number_of_decoded_words;
+                number_of_words -= number_of_decoded_words;
+                chunk = end;
+                decode_begin = std::chrono::steady_clock::now();
+            }
+        }
+
+        Filter _filter;
+        batch_fifo<typename Mode::event> _fifo;
+        std::unique_ptr<spill_ring> _spill_ring;
+        std::unique_ptr<decoding_pool> _decoding_pool;
+        std::size_t _parallel_decoding_words;
+        std::atomic_bool _discard_requested;
+        bool _dropped;
+        bool _overflow_episode;
+    };
+
+    /// specialized_batch_camera represents a template-specialized ATIS connected to an Opal Kelly board.
+    /// The events handler is called with contiguous spans of events, whose type is given by the decode mode.
+    /// The filters are applied by the decoding thread, so that removed events never reach the host FIFO.
+    template <
+        typename HandleBatch,
+        typename HandleException,
+        typename Filter = filter_chain<>,
+        typename Mode = atis_mode>
+    class specialized_batch_camera : public decoding_camera<Filter, Mode> {
+        public:
+        specialized_batch_camera(
+            HandleBatch handle_batch,
+            HandleException handle_exception,
+            std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter,
+            std::size_t fifo_size,
+            std::string serial,
+            std::chrono::milliseconds sleep_duration,
+            std::unique_ptr<front_panel> opened_front_panel = std::unique_ptr<front_panel>(),
+            Filter filter = Filter()) :
+            decoding_camera<Filter, Mode>(
+                std::move(unvalidated_parameter),
+                fifo_size,
+                serial,
+                sleep_duration,
+                std::move(opened_front_panel),
+                std::forward<Filter>(filter)),
+            _handle_batch(std::forward<HandleBatch>(handle_batch)),
+            _handle_exception(std::forward<HandleException>(handle_exception)),
+            _buffer_running(true) {
+            _buffer_loop = std::thread([this, sleep_duration]() -> void {
+                try {
+                    this->dispatch(_handle_batch, _buffer_running, sleep_duration);
+                } catch (...) {
+                    this->_handle_exception(std::current_exception());
+                }
+            });
+            this->start_dispatching(_buffer_running, _buffer_loop);
+        }
+        specialized_batch_camera(const specialized_batch_camera&) = delete;
+        specialized_batch_camera(specialized_batch_camera&&) = delete;
+        specialized_batch_camera& operator=(const specialized_batch_camera&) = delete;
+        specialized_batch_camera& operator=(specialized_batch_camera&&) = delete;
+        virtual ~specialized_batch_camera() {
+            this->stop();
+            _buffer_running.store(false, std::memory_order_relaxed);
+            _buffer_loop.join();
+        }
+
+        protected:
+        virtual void handle_acquisition_exception(std::exception_ptr exception) override {
+            this->_handle_exception(exception);
+        }
+
+        HandleBatch _handle_batch;
+        HandleException _handle_exception;
+        std::atomic_bool _buffer_running;
+        std::thread _buffer_loop;
+    };
+
+    /// each_event adapts an events handler to a batch handler, by calling it with each event of the spans.
+    template <typename HandleEvent, typename Event>
+    class each_event {
+        public:
+        each_event(HandleEvent handle_event) : _handle_event(std::forward<HandleEvent>(handle_event)) {}
+        each_event(const each_event&) = default;
+        each_event(each_event&&) = default;
+        each_event& operator=(const each_event&) = default;
+        each_event& operator=(each_event&&) = default;
+        virtual ~each_event() {}
+
+        /// operator() calls the events handler with each event.
+        void operator()(span<const Event> events) {
+            for (const auto event : events) {
+                _handle_event(event);
+            }
+        }
+
+        protected:
+        HandleEvent _handle_event;
+    };
+
+    /// specialized_camera represents a template-specialized ATIS connected to an Opal Kelly board.
+    /// The events handler is called with individual events, whose type is given by the decode mode.
+    /// It is a batch camera whose handler calls the events handler with each event of the spans, hence the events
+    /// are published in bulk to the host FIFO and dispatched by a single thread.
+    template <
+        typename HandleEvent,
+        typename HandleException,
+        typename Filter = filter_chain<>,
+        typename Mode = atis_mode>
+    class specialized_camera : public specialized_batch_camera<
+                                   each_event<HandleEvent, typename Mode::event>,
+                                   HandleException,
+                                   Filter,
+                                   Mode> {
+        public:
+        specialized_camera(
+            HandleEvent handle_event,
+            HandleException handle_exception,
+            std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter,
+            std::size_t fifo_size,
+            std::string serial,
+            std::chrono::milliseconds sleep_duration,
+            std::unique_ptr<front_panel> opened_front_panel = std::unique_ptr<front_panel>(),
+            Filter filter = Filter()) :
+            specialized_batch_camera<each_event<HandleEvent, typename Mode::event>, HandleException, Filter, Mode>(
+                each_event<HandleEvent, typename Mode::event>(std::forward<HandleEvent>(handle_event)),
+                std::forward<HandleException>(handle_exception),
+                std::move(unvalidated_parameter),
+                fifo_size,
+                serial,
+                sleep_duration,
+                std::move(opened_front_panel),
+                std::forward<Filter>(filter)) {}
+        specialized_camera(const specialized_camera&) = delete;
+        specialized_camera(specialized_camera&&) = delete;
+        specialized_camera& operator=(const specialized_camera&) = delete;
+        specialized_camera& operator=(specialized_camera&&) = delete;
+        virtual ~specialized_camera() {}
+    };
+
+    /// make_camera creates a camera from functors.
+    /// The decode mode is given as an explicit template parameter, for instance make_camera<dvs_mode>(...).
+    template <
+        typename Mode = atis_mode,
+        typename HandleEvent,
+        typename HandleException,
+        typename Filter = filter_chain<>>
+    std::unique_ptr<specialized_camera<HandleEvent, HandleException, Filter, Mode>> make_camera(
+        HandleEvent handle_event,
+        HandleException handle_exception,
+        std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter =
+            std::unique_ptr<sepia::unvalidated_parameter>(),
+        std::size_t fifo_size = 1 << 24,
+        std::string serial = std::string(),
+        std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10),
+        Filter filter = Filter()) {
+        return sepia::make_unique<specialized_camera<HandleEvent, HandleException, Filter, Mode>>(
+            std::forward<HandleEvent>(handle_event),
+            std::forward<HandleException>(handle_exception),
+            std::move(unvalidated_parameter),
+            fifo_size,
+            serial,
+            sleep_duration,
+            std::unique_ptr<front_panel>(),
+            std::forward<Filter>(filter));
+    }
+
+    /// make_camera creates a camera from functors and an opened front panel.
+    template <
+        typename Mode = atis_mode,
+        typename HandleEvent,
+        typename HandleException,
+        typename Filter = filter_chain<>>
+    std::unique_ptr<specialized_camera<HandleEvent, HandleException, Filter, Mode>> make_camera(
+        HandleEvent handle_event,
+        HandleException handle_exception,
+        std::unique_ptr<front_panel> opened_front_panel,
+        std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter =
+            std::unique_ptr<sepia::unvalidated_parameter>(),
+        std::size_t fifo_size = 1 << 24,
+        std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10),
+        Filter filter = Filter()) {
+        return sepia::make_unique<specialized_camera<HandleEvent, HandleException, Filter, Mode>>(
+            std::forward<HandleEvent>(handle_event),
+            std::forward<HandleException>(handle_exception),
+            std::move(unvalidated_parameter),
+            fifo_size,
+            std::string(),
+            sleep_duration,
+            std::move(opened_front_panel),
+            std::forward<Filter>(filter));
+    }
+
+    /// make_batch_camera creates a camera whose events handler is called with spans of events.
+    template <
+        typename Mode = atis_mode,
+        typename HandleBatch,
+        typename HandleException,
+        typename Filter = filter_chain<>>
+    std::unique_ptr<specialized_batch_camera<HandleBatch, HandleException, Filter, Mode>> make_batch_camera(
+        HandleBatch handle_batch,
+        HandleException handle_exception,
+        std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter =
+            std::unique_ptr<sepia::unvalidated_parameter>(),
+        std::size_t fifo_size = 1 << 24,
+        std::string serial = std::string(),
+        std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10),
+        Filter filter = Filter()) {
+        return sepia::make_unique<specialized_batch_camera<HandleBatch, HandleException, Filter, Mode>>(
+            std::forward<HandleBatch>(handle_batch),
+            std::forward<HandleException>(handle_exception),
+            std::move(unvalidated_parameter),
+            fifo_size,
+            serial,
+            sleep_duration,
+            std::unique_ptr<front_panel>(),
+            std::forward<Filter>(filter));
+    }
+
+    /// make_batch_camera creates a camera from functors and an opened front panel.
+    template <
+        typename Mode = atis_mode,
+        typename HandleBatch,
+        typename HandleException,
+        typename Filter = filter_chain<>>
+    std::unique_ptr<specialized_batch_camera<HandleBatch, HandleException, Filter, Mode>> make_batch_camera(
+        HandleBatch handle_batch,
+        HandleException handle_exception,
+        std::unique_ptr<front_panel> opened_front_panel,
+        std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter =
+            std::unique_ptr<sepia::unvalidated_parameter>(),
+        std::size_t fifo_size = 1 << 24,
+        std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10),
+        Filter filter = Filter()) {
+        return sepia::make_unique<specialized_batch_camera<HandleBatch, HandleException, Filter, Mode>>(
+            std::forward<HandleBatch>(handle_batch),
+            std::forward<HandleException>(handle_exception),
+            std::move(unvalidated_parameter),
+            fifo_size,
+            std::string(),
+            sleep_duration,
+            std::move(opened_front_panel),
+            std::forward<Filter>(filter));
+    }
+
+    /// specialized_pull_camera represents a template-specialized ATIS whose events are pulled by the consumer,
+    /// instead of being pushed to a handler by a dispatching thread.
+    /// file_descriptor becomes readable (for poll, select or epoll) once batch_events events are available, or once
+    /// the oldest available event has waited for latency, and drain copies the events out without blocking.
+    /// The latency is checked when events are published and when the board is idle, hence the reading thread's
+    /// waits are capped at latency.
+    /// A single reactor thread can therefore service many cameras.
+    template <typename Filter = filter_chain<>, typename Mode = atis_mode>
+    class specialized_pull_camera : public decoding_camera<Filter, Mode> {
+        public:
+        specialized_pull_camera(
+            std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter,
+            std::size_t fifo_size,
+            std::string serial,
+            std::chrono::milliseconds sleep_duration,
+            std::size_t batch_events,
+            std::chrono::microseconds latency,
+            std::unique_ptr<front_panel> opened_front_panel = std::unique_ptr<front_panel>(),
+            Filter filter = Filter()) :
+            decoding_camera<Filter, Mode>(
+                std::move(unvalidated_parameter),
+                fifo_size,
+                serial,
+                sleep_duration,
+                std::move(opened_front_panel),
+                std::forward<Filter>(filter)),
+            _batch_events(std::max(batch_events, static_cast<std::size_t>(1))),
+            _latency(latency),
+            _armed(true),
+            _pending_since(0) {
+#ifdef __linux__
+            _file_descriptors[0] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            _file_descriptors[1] = _file_descriptors[0];
+            if (_file_descriptors[0] < 0) {
+                throw std::runtime_error(std::string("creating the eventfd failed (") + std::strerror(errno) + ")");
+            }
+#else
+            if (pipe(_file_descriptors.data()) != 0) {
+                throw std::runtime_error(std::string("creating the pipe failed (") + std::strerror(errno) + ")");
+            }
+            for (const auto file_descriptor : _file_descriptors) {
+                fcntl(file_descriptor, F_SETFL, fcntl(file_descriptor, F_GETFL) | O_NONBLOCK);
+                fcntl(file_descriptor, F_SETFD, FD_CLOEXEC);
+            }
+#endif
+            this->_polling_scheduler->limit_wait(_latency);
+            this->start();
+        }
+        specialized_pull_camera(const specialized_pull_camera&) = delete;
+        specialized_pull_camera(specialized_pull_camera&&) = delete;
+        specialized_pull_camera& operator=(const specialized_pull_camera&) = delete;
+        specialized_pull_camera& operator=(specialized_pull_camera&&) = delete;
+        virtual ~specialized_pull_camera() {
+            this->stop();
+            close(_file_descriptors[0]);
+            if (_file_descriptors[1] != _file_descriptors[0]) {
+                close(_file_descriptors[1]);
+            }
+        }
+
+        /// file_descriptor returns a descriptor which is readable while events or an exception wait for drain.
+        /// It must only be polled, drain clears it.
+        int file_descriptor() const {
+            return _file_descriptors[0];
+        }
+
+        /// drain copies the available events to the given span without blocking, and returns the number of events.
+        /// The descriptor stays readable until the FIFO is emptied.
+        /// If the acquisition stopped on an exception, drain rethrows it once the events published before are drained.
+        std::size_t drain(span<typename Mode::event> events) {
+            this->discard_requested_events();
+            std::size_t number_of_events = 0;
+            while (number_of_events < events.size()) {
+                const auto available_events = this->_fifo.readable();
+                if (available_events.empty()) {
+                    break;
+                }
+                const auto number_of_copied_events =
+                    std::min(available_events.size(), events.size() - number_of_events);
+                std::copy(
+                    available_events.begin(),
+                    available_events.begin() + number_of_copied_events,
+                    events.begin() + number_of_events);
+                this->_fifo.release(number_of_copied_events);
+                number_of_events += number_of_copied_events;
+            }
+            if (number_of_events == 0) {
+                std::lock_guard<std::mutex> lock(_exception_mutex);
+                if (_exception) {
+                    std::rethrow_exception(_exception);
+                }
+            }
+            if (this->_fifo.occupancy() == 0) {
+                // clear the descriptor before re-arming it, so that events published in between notify again
+                clear();
+                _pending_since.store(0, std::memory_order_release);
+                _armed.store(true, std::memory_order_release);
+                notify_if_ready();
+            }
+            return number_of_events;
+        }
+
+        protected:
+        virtual void handle_published() override {
+            notify_if_ready();
+        }
+
+        virtual void handle_idle() override {
+            notify_if_ready();
+        }
+
+        /// handle_acquisition_exception keeps the exception for drain and makes the descriptor readable.
+        virtual void handle_acquisition_exception(std::exception_ptr exception) override {
+            {
+                std::lock_guard<std::mutex> lock(_exception_mutex);
+                if (!_exception) {
+                    _exception = exception;
+                }
+            }
+            _armed.store(false, std::memory_order_release);
+            signal();
+        }
+
+        /// notify_if_ready makes the descriptor readable if the consumer waits and the batch or latency threshold is
+        /// reached. It is called by the reading and decoding threads, and by drain.
+        void notify_if_ready() {
+            const auto occupancy = this->_fifo.occupancy();
+            if (occupancy == 0 || !_armed.load(std::memory_order_acquire)) {
+                return;
+            }
+            const auto now = static_cast<int64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count());
+            auto pending_since = _pending_since.load(std::memory_order_acquire);
+            if (pending_since == 0 && _pending_since.compare_exchange_strong(pending_since, now)) {
+                pending_since = now;
+            }
+            if ((occupancy >= _batch_events || std::chrono::nanoseconds(now - pending_since) >= _latency)
+                && _armed.exchange(false)) {
+                signal();
+            }
+        }
+
+        /// signal makes the descriptor readable.
+        void signal() {
+#ifdef __linux__
+            const uint64_t value = 1;
+            const auto written = write(_file_descriptors[1], &value, sizeof(value));
+#else
+            const uint8_t value = 1;
+            const auto written = write(_file_descriptors[1], &value, sizeof(value));
+#endif
+            (void)written;
+        }
+
+        /// clear consumes the pending signals, so that the descriptor is not readable anymore.
+        void clear() {
+#ifdef __linux__
+            uint64_t value;
+            const auto read_size = read(_file_descriptors[0], &value, sizeof(value));
+            (void)read_size;
+#else
+            std::array<uint8_t, 64> values;
+            while (read(_file_descriptors[0], values.data(), values.size()) > 0) {
+            }
+#endif
+        }
+
+        const std::size_t _batch_events;
+        const std::chrono::microseconds _latency;
+        std::array<int, 2> _file_descriptors;
+        std::atomic_bool _armed;
+        std::atomic<int64_t> _pending_since;
+        std::mutex _exception_mutex;
+        std::exception_ptr _exception;
+    };
+
+    /// make_pull_camera creates a camera whose events are pulled with drain, once its file descriptor is readable.
+    template <typename Mode = atis_mode, typename Filter = filter_chain<>>
+    std::unique_ptr<specialized_pull_camera<Filter, Mode>> make_pull_camera(
+        std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter =
+            std::unique_ptr<sepia::unvalidated_parameter>(),
+        std::size_t batch_events = 1 << 12,
+        std::chrono::microseconds latency = std::chrono::microseconds(1000),
+        std::size_t fifo_size = 1 << 24,
+        std::string serial = std::string(),
+        std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10),
+        Filter filter = Filter()) {
+        return sepia::make_unique<specialized_pull_camera<Filter, Mode>>(
+            std::move(unvalidated_parameter),
+            fifo_size,
+            serial,
+            sleep_duration,
+            batch_events,
+            latency,
+            std::unique_ptr<front_panel>(),
+            std::forward<Filter>(filter));
+    }
+
+    /// make_pull_camera creates a pull camera from an opened front panel.
+    template <typename Mode = atis_mode, typename Filter = filter_chain<>>
+    std::unique_ptr<specialized_pull_camera<Filter, Mode>> make_pull_camera(
+        std::unique_ptr<front_panel> opened_front_panel,
+        std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter =
+            std::unique_ptr<sepia::unvalidated_parameter>(),
+        std::size_t batch_events = 1 << 12,
+        std::chrono::microseconds latency = std::chrono::microseconds(1000),
+        std::size_t fifo_size = 1 << 24,
+        std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10),
+        Filter filter = Filter()) {
+        return sepia::make_unique<specialized_pull_camera<Filter, Mode>>(
+            std::move(unvalidated_parameter),
+            fifo_size,
+            std::string(),
+            sleep_duration,
+            batch_events,
+            latency,
+            std::move(opened_front_panel),
+            std::forward<Filter>(filter));
+    }
+
+    /// tagged_atis_event is an ATIS event produced by one of the cameras of a multi-camera.
+    struct tagged_atis_event {
+        uint64_t t;
+        uint16_t x;
+        uint16_t y;
+        bool is_threshold_crossing;
+        bool polarity;
+        uint8_t camera;
+    };
+
+    /// camera_source is a camera polled by the threads of a multi-camera instead of its own.
+    /// The events are decoded by the polling thread and published to a FIFO, read by the multi-camera's merging
+    /// thread. Since the polling threads are shared between cameras, the source ignores several acquisition
+    /// parameters:
+    ///     - the transfer ring is released, whether the acquisition is pipelined or streaming: streaming reads are
+    ///       chunked as configured, but each chunk is decoded by the polling thread before the next is read
+    ///     - the decoding threads are not started, and the overflow policy is fail
+    ///     - the polling policy and the threads placement are replaced by the multi-camera's polling threads
+    /// The events are decoded in ATIS mode, without filters.
+    class camera_source : public camera {
+        public:
+        camera_source(
+            std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter,
+            std::size_t fifo_size,
+            std::string serial,
+            std::chrono::milliseconds sleep_duration,
+            std::unique_ptr<front_panel> opened_front_panel = std::unique_ptr<front_panel>()) :
+            camera(std::move(unvalidated_parameter), serial, sleep_duration, std::move(opened_front_panel)),
+            _fifo(fifo_size, _huge_pages),
+            _watermark(0) {
+            _transfer_ring.reset();
+            _overflow_policy = overflow_policy::fail;
+        }
+        camera_source(const camera_source&) = delete;
+        camera_source(camera_source&&) = delete;
+        camera_source& operator=(const camera_source&) = delete;
+        camera_source& operator=(camera_source&&) = delete;
+        virtual ~camera_source() {
+            stop();
         }
 
-        /// width returns the sensor width.
-        static constexpr uint16_t width() {
-            return 304;
+        /// acquire polls the board once and publishes the decoded events.
+        /// events_data must hold read_buffer_words() * 4 bytes. The board's FIFO fill level is returned.
+        std::size_t acquire(uint8_t* events_data) {
+            std::chrono::nanoseconds poll_duration;
+            return poll(events_data, poll_duration);
         }
 
-        /// height returns the sensor height.
-        static constexpr uint16_t height() {
-            return 240;
+        /// fifo returns the published events.
+        batch_fifo<sepia::atis_event>& fifo() {
+            return _fifo;
         }
 
-        /// configuration contains the settings for the digital-to-analog converters on the FPGA.
-        static std::
-            unordered_map<std::string, std::unordered_map<std::string, std::unordered_map<std::string, uint32_t>>>
-            configuration() {
-            return {
-                {"change_detection",
-                 {
-                     {"reset_switch_bulk_potential", {{"address", 0x02}, {"tension", 0x5900}}},
-                     {"photoreceptor_feedback", {{"address", 0x03}, {"tension", 0x5900}}},
-                     {"refractory_period", {{"address", 0x04}, {"tension", 0x5900}}},
-                     {"follower", {{"address", 0x05}, {"tension", 0x5900}}},
-                     {"event_source_amplifier", {{"address", 0x06}, {"tension", 0x7900}}},
-                     {"on_event_threshold", {{"address", 0x07}, {"tension", 0x7900}}},
-                     {"off_event_threshold", {{"address", 0x08}, {"tension", 0x7900}}},
-                     {"off_event_inverter", {{"address", 0x09}, {"tension", 0x7900}}},
-                     {"cascode_photoreceptor_feedback", {{"address", 0x0a}, {"tension", 0x7900}}},
-                 }},
-                {"exposure_measurement",
-                 {
-                     {"comparator_tail", {{"address", 0x0b}, {"tension", 0x7900}}},
-                     {"comparator_hysteresis", {{"address", 0x0c}, {"tension", 0x7900}}},
-                     {"comparator_output_stage", {{"address", 0x0d}, {"tension", 0x7900}}},
-                     {"upper_threshold", {{"address", 0x0e}, {"tension", 0x5900}}},
-                     {"lower_threshold", {{"address", 0x0f}, {"tension", 0x5900}}},
-                 }},
-                {"pullup",
-                 {
-                     {"exposure_measurement_abscissa_request", {{"address", 0x10}, {"tension", 0x5900}}},
-                     {"exposure_measurement_ordinate_request", {{"address", 0x11}, {"tension", 0x5900}}},
-                     {"change_detection_abscissa_request", {{"address", 0x12}, {"tension", 0x5900}}},
-                     {"change_detection_ordinate_request", {{"address", 0x13}, {"tension", 0x5900}}},
-                     {"abscissa_acknoledge", {{"address", 0x14}, {"tension", 0x5900}}},
-                     {"abscissa_encoder", {{"address", 0x15}, {"tension", 0x7900}}},
-                     {"ordinate_encoder", {{"address", 0x16}, {"tension", 0x7900}}},
-                 }},
-                {"control",
-                 {
-                     {"exposure_measurement_timeout", {{"address", 0x17}, {"tension", 0x7900}}},
-                     {"sequential_exposure_measurement_timeout", {{"address", 0x18}, {"tension", 0x7900}}},
-                     {"abscissa_acknoledge_timeout", {{"address", 0x19}, {"tension", 0x7900}}},
-                     {"latch_cell_scan_pulldown", {{"address", 0x1a}, {"tension", 0x7900}}},
-                     {"abscissa_request_pulldown", {{"address", 0x1b}, {"tension", 0x7900}}},
-                 }},
-                {"static",
-                 {
-                     {"reset_t", {{"address", 0x00}, {"tension", 0x5900}, {"value", 0}}},
-                     {"test_event", {{"address", 0x01}, {"tension", 0x7900}, {"value", 0}}},
-                     {"reset_photodiodes", {{"address", 0x1c}, {"tension", 0x00}, {"value", 3}}},
-                 }},
-            };
+        /// read_buffer_words returns the maximum number of words read by a poll.
+        std::size_t read_buffer_words() const {
+            return _read_buffer_words;
         }
 
-        camera() = default;
-        camera(const camera&) = delete;
-        camera(camera&&) = default;
-        camera& operator=(const camera&) = delete;
-        camera& operator=(camera&&) = default;
-        virtual ~camera() {}
+        /// memory returns the host memory used by the source's FIFO.
+        /// The read buffers are owned by the multi-camera's polling threads.
+        virtual memory_statistics memory() const override {
+            memory_statistics statistics{};
+            statistics.allocated_fifo_bytes = _fifo.allocated_size();
+            statistics.resident_fifo_bytes = _fifo.resident_size();
+            return statistics;
+        }
 
-        /// trigger sends a trigger signal to the camera.
-        /// with default settings, this signal will trigger a change detection on every pixel.
-        virtual void trigger() = 0;
+        /// shift_timestamps adds an offset to the timestamps of the decoded events.
+        /// It must be called before the first acquire.
+        void shift_timestamps(uint64_t offset) {
+            _t_offset += offset;
+            _watermark.store(_t_offset, std::memory_order_release);
+        }
+
+        /// watermark returns the sensor time up to which the events are published.
+        /// It is updated after the events, hence reading it before the FIFO guarantees that the events with
+        /// smaller timestamps are readable.
+        uint64_t watermark() const {
+            return _watermark.load(std::memory_order_acquire);
+        }
+
+        protected:
+        /// handle_words decodes the words in place in the FIFO, and advances the watermark.
+        virtual void handle_words(
+            const uint8_t* data,
+            std::size_t number_of_words,
+            std::chrono::steady_clock::time_point read_time) override {
+            uint64_t t = _t_offset;
+            while (number_of_words > 0) {
+                const auto events = _fifo.writable();
+                if (events.empty()) {
+                    throw std::runtime_error("Computer's FIFO overflow");
+                }
+                const auto number_of_decoded_words = std::min(events.size(), number_of_words);
+                const auto t_offset = _t_offset;
+                const auto decode_begin = std::chrono::steady_clock::now();
+                const auto number_of_events = decode(data, number_of_decoded_words, _t_offset, events.data());
+                _counters.count_decode(
+                    number_of_decoded_words,
+                    number_of_events,
+                    static_cast<std::size_t>((_t_offset - t_offset) >> 13),
+                    0,
+                    std::chrono::steady_clock::now() - decode_begin);
+                if (number_of_events > 0) {
+                    t = std::max(t, events[number_of_events - 1].t);
+                }
+                _fifo.commit(number_of_events);
+                _counters.count_push(number_of_events, _fifo.occupancy());
+                data += 4 * number_of_decoded_words;
+                number_of_words -= number_of_decoded_words;
+            }
+            _counters.count_enqueue(std::chrono::steady_clock::now() - read_time);
+            _host_clock.update(std::max(t, _t_offset), read_time);
+            _watermark.store(std::max(t, _t_offset), std::memory_order_release);
+        }
+
+        /// handle_acquisition_exception is not used, since acquire throws to the multi-camera's polling thread.
+        virtual void handle_acquisition_exception(std::exception_ptr) override {}
+
+        batch_fifo<sepia::atis_event> _fifo;
+        std::atomic<uint64_t> _watermark;
     };
 
-    /// specialized_camera represents a template-specialized ATIS connected to an Opal Kelly board.
-    template <typename HandleEvent, typename HandleException>
-    class specialized_camera : public camera,
-                               public sepia::specialized_camera<sepia::atis_event, HandleEvent, HandleException> {
+    /// disconnection_policy lists the multi-camera behaviours when a camera is disconnected.
+    ///     - stop: the acquisition stops and the exception handler is called
+    ///     - continue_without: the camera's remaining events are delivered, and the other cameras keep running
+    ///       (the exception handler is called if every camera is disconnected)
+    enum class disconnection_policy {
+        stop,
+        continue_without,
+    };
+
+    /// multi_camera_statistics is a snapshot of a multi-camera's counters.
+    /// total accumulates the statistics of the cameras. late_events counts the events delivered after events with
+    /// larger timestamps, because their camera lagged behind the others by more than the lateness bound.
+    struct multi_camera_statistics {
+        acquisition_statistics total;
+        std::vector<acquisition_statistics> cameras;
+        std::vector<bool> connected;
+        uint64_t merged_events;
+        uint64_t late_events;
+    };
+
+    /// specialized_multi_camera acquires events from several ATIS connected to Opal Kelly boards, and delivers a
+    /// single stream ordered by timestamp. The cameras are opened in parallel, and polled by a bounded number of
+    /// threads. A merging thread performs a k-way merge of the cameras' FIFOs: an event is delivered once every
+    /// connected camera has published the events up to its timestamp, or once it is older than the most advanced
+    /// camera's time minus the lateness bound, so that a silent camera delays the others by at most the bound.
+    /// The boards' clocks start independently, since the cameras are opened in parallel and the startup duration
+    /// depends on the firmware upload. Hence the timestamps are shifted onto a common time base before merging: each
+    /// camera's timestamps are offset by the delay between its acquisition start and the earliest one, so that the
+    /// merged timestamps count microseconds since the first board started.
+    /// The events handler is called with contiguous spans of tagged events.
+    template <typename HandleBatch, typename HandleException>
+    class specialized_multi_camera {
         public:
-        specialized_camera<HandleEvent, HandleException>(
-            HandleEvent handle_event,
+        specialized_multi_camera(
+            HandleBatch handle_batch,
             HandleException handle_exception,
-            std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter,
+            std::vector<std::string> serials,
+            std::vector<std::unique_ptr<front_panel>> opened_front_panels,
+            std::vector<std::unique_ptr<sepia::unvalidated_parameter>> unvalidated_parameters,
+            std::chrono::microseconds lateness,
+            std::size_t number_of_threads,
+            disconnection_policy policy,
             std::size_t fifo_size,
-            std::string serial,
             std::chrono::milliseconds sleep_duration) :
-            sepia::specialized_camera<sepia::atis_event, HandleEvent, HandleException>(
-                std::forward<HandleEvent>(handle_event),
-                std::forward<HandleException>(handle_exception),
-                fifo_size,
-                sleep_duration),
-            _parameter(default_parameter()),
-            _acquisition_running(true),
-            _t_offset(0) {
-            _parameter->parse_or_load(std::move(unvalidated_parameter));
-
-            // check wether the serial exists and is an ATIS camera
-            // default to the first serial found if an empty string is given as serial
-            {
-                const auto serials = available_serials();
-                if (serials.empty()) {
-                    throw sepia::no_device_connected("Opal Kelly ATIS");
-                } else {
-                    if (serial.empty()) {
-                        serial = *serials.begin();
-                    } else if (std::find(serials.begin(), serials.end(), serial) == serials.end()) {
-                        throw sepia::no_device_connected("Opal Kelly ATIS");
-                    }
-                }
+            _handle_batch(std::forward<HandleBatch>(handle_batch)),
+            _handle_exception(std::forward<HandleException>(handle_exception)),
+            _lateness(static_cast<uint64_t>(lateness.count())),
+            _policy(policy),
+            _sleep_duration(sleep_duration),
+            _polling_running(true),
+            _merging_running(true),
+            _exception_handled(false),
+            _merged_events(0),
+            _late_events(0) {
+            const auto number_of_cameras = std::max(serials.size(), opened_front_panels.size());
+            if (number_of_cameras == 0) {
+                throw std::runtime_error("a multi-camera requires at least one camera");
             }
-
-            // open the connection to the ATIS
-            {
-                const auto serial_error = _opal_kelly_front_panel.OpenBySerial(serial);
-                if (serial_error != okCFrontPanel::NoError) {
-                    throw std::runtime_error(
-                        "connection to the serial '" + serial + "' raised the error " + std::to_string(serial_error));
-                }
+            if (number_of_cameras > 256) {
+                throw std::runtime_error("a multi-camera supports at most 256 cameras");
             }
+            serials.resize(number_of_cameras);
+            opened_front_panels.resize(number_of_cameras);
+            unvalidated_parameters.resize(number_of_cameras);
 
-            // load the defaut PLL configuration
+            // open the cameras in parallel, since loading the firmware dominates the startup
+            _sources.resize(number_of_cameras);
             {
-                const auto pll_error = _opal_kelly_front_panel.LoadDefaultPLLConfiguration();
-                if (pll_error != okCFrontPanel::NoError) {
-                    throw std::runtime_error(
-                        "the default PLL configuration loading raised the error " + std::to_string(pll_error));
+                std::vector<std::exception_ptr> exceptions(number_of_cameras);
+                std::vector<std::thread> opening_threads;
+                for (std::size_t index = 0; index < number_of_cameras; ++index) {
+                    opening_threads.emplace_back([&, index]() -> void {
+                        try {
+                            _sources[index] = sepia::make_unique<camera_source>(
+                                std::move(unvalidated_parameters[index]),
+                                fifo_size,
+                                serials[index],
+                                sleep_duration,
+                                std::move(opened_front_panels[index]));
+                        } catch (...) {
+                            exceptions[index] = std::current_exception();
+                        }
+                    });
+                }
+                for (auto& opening_thread : opening_threads) {
+                    opening_thread.join();
+                }
+                for (const auto& exception : exceptions) {
+                    if (exception) {
+                        std::rethrow_exception(exception);
+                    }
                 }
             }
 
-            // load the firmware
+            // shift the cameras' timestamps onto the clock of the first board to start
             {
-                std::string firmware_filename = _parameter->get_string({"firmware"});
-                std::ifstream firmware_file(firmware_filename);
-                if (!firmware_file.good()) {
-                    throw std::runtime_error(
-                        "the firmware file '" + firmware_filename + "' does not exist or is not readable");
+                auto earliest_start = _sources.front()->startup().acquisition_start;
+                for (const auto& source : _sources) {
+                    earliest_start = std::min(earliest_start, source->startup().acquisition_start);
                 }
-
-                const auto firmware_error = _opal_kelly_front_panel.ConfigureFPGA(firmware_filename);
-                if (firmware_error != okCFrontPanel::NoError) {
-                    throw std::runtime_error(
-                        "the firmware loading from file '" + firmware_filename + "' raised the error "
-                        + std::to_string(firmware_error));
+                for (const auto& source : _sources) {
+                    source->shift_timestamps(static_cast<uint64_t>(
+                        std::chrono::duration_cast<std::chrono::microseconds>(
+                            source->startup().acquisition_start - earliest_start)
+                            .count()));
                 }
             }
-
-            // open the biases and selection settings
-            _opal_kelly_front_panel.SetWireInValue(0x00, 1 << 5, 1 << 5);
-            _opal_kelly_front_panel.UpdateWireIns();
-
-            // initialise the digital-to-analog converters (biases setup)
-            for (const auto& category_pair : configuration()) {
-                for (const auto& setting_pair : category_pair.second) {
-                    _opal_kelly_front_panel.SetWireInValue(
-                        0x01,
-                        category_pair.first == "static" ?
-                            setting_pair.second.at("value") :
-                            static_cast<uint32_t>(_parameter->get_number({category_pair.first, setting_pair.first})));
-                    _opal_kelly_front_panel.SetWireInValue(0x02, setting_pair.second.at("tension"));
-                    _opal_kelly_front_panel.SetWireInValue(0x03, setting_pair.second.at("address"));
-                    _opal_kelly_front_panel.UpdateWireIns();
-                    _opal_kelly_front_panel.ActivateTriggerIn(0x40, 1);
-                }
+            _connected.reset(new std::atomic_bool[number_of_cameras]);
+            for (std::size_t index = 0; index < number_of_cameras; ++index) {
+                _connected[index].store(true, std::memory_order_release);
             }
-            _opal_kelly_front_panel.ActivateTriggerIn(0x40, 6);
 
-            // load the region of interest parameters
-            if (_parameter->get_array_parameter({"columns_selection"}).size() > 0
-                || _parameter->get_array_parameter({"rows_selection"}).size() > 0) {
-                // compute the columns fill bits
-                auto fill = std::vector<bool>();
-                fill.reserve(544);
-                if (_parameter->get_array_parameter({"columns_selection"}).size() > 0) {
-                    auto state = _parameter->get_boolean({"select_first_column"});
-                    auto first_pass = true;
-                    while (fill.size() < 304) {
-                        for (const auto& column_count : _parameter->get_array_parameter({"columns_selection"})) {
-                            for (uint16_t index = 0; index < static_cast<uint16_t>(column_count->get_number({}));
-                                 ++index) {
-                                if (fill.size() >= 304) {
-                                    if (first_pass) {
-                                        throw std::runtime_error("The columns selection sum is larger than 304");
-                                    } else {
-                                        break;
-                                    }
-                                }
-                                fill.push_back(state);
-                            }
-                            state = !state;
-                        }
-                        if (first_pass) {
-                            first_pass = false;
-                        }
+            // poll the cameras round-robin, each thread owning every number_of_threads-th camera
+            number_of_threads = std::max(std::min(number_of_threads, number_of_cameras), static_cast<std::size_t>(1));
+            for (std::size_t thread_index = 0; thread_index < number_of_threads; ++thread_index) {
+                _polling_loops.emplace_back([this, thread_index, number_of_threads]() -> void {
+                    std::size_t read_buffer_words = 0;
+                    for (auto index = thread_index; index < _sources.size(); index += number_of_threads) {
+                        read_buffer_words = std::max(read_buffer_words, _sources[index]->read_buffer_words());
                     }
-                    std::reverse(fill.begin(), fill.end());
-                } else {
-                    fill = std::vector<bool>(304);
-                }
-
-                // compute the rows fill bits
-                if (_parameter->get_array_parameter({"rows_selection"}).size() > 0) {
-                    auto state = _parameter->get_boolean({"select_first_row"});
-                    auto first_pass = true;
-                    while (fill.size() < 544) {
-                        for (const auto& column_count : _parameter->get_array_parameter({"rows_selection"})) {
-                            for (uint16_t index = 0; index < static_cast<uint16_t>(column_count->get_number({}));
-                                 ++index) {
-                                if (fill.size() >= 544) {
-                                    if (first_pass) {
-                                        throw std::runtime_error("The rows selection sum is larger than 240");
-                                    } else {
-                                        break;
-                                    }
+                    aligned_buffer events_data(read_buffer_words * 4);
+                    while (_polling_running.load(std::memory_order_relaxed)) {
+                        std::size_t number_of_words = 0;
+                        for (auto index = thread_index; index < _sources.size(); index += number_of_threads) {
+                            if (_connected[index].load(std::memory_order_acquire)) {
+                                try {
+                                    number_of_words += _sources[index]->acquire(events_data.data());
+                                } catch (...) {
+                                    disconnect(index, std::current_exception());
                                 }
-                                fill.push_back(state);
-                            }
-                            if (fill.size() >= 544) {
-                                break;
                             }
-                            state = !state;
                         }
-                        if (first_pass) {
-                            first_pass = false;
+                        if (number_of_words == 0) {
+                            std::this_thread::sleep_for(_sleep_duration);
                         }
                     }
-                    std::reverse(fill.begin() + 304, fill.end());
-                } else {
-                    auto fill_rows = std::vector<bool>(240);
-                    fill.insert(fill.end(), fill_rows.begin(), fill_rows.end());
+                });
+            }
+            _merging_loop = std::thread([this]() -> void {
+                try {
+                    merge();
+                } catch (...) {
+                    _polling_running.store(false, std::memory_order_relaxed);
+                    handle_exception_once(std::current_exception());
                 }
+            });
+        }
+        specialized_multi_camera(const specialized_multi_camera&) = delete;
+        specialized_multi_camera(specialized_multi_camera&&) = delete;
+        specialized_multi_camera& operator=(const specialized_multi_camera&) = delete;
+        specialized_multi_camera& operator=(specialized_multi_camera&&) = delete;
+        virtual ~specialized_multi_camera() {
+            _polling_running.store(false, std::memory_order_relaxed);
+            for (auto& polling_loop : _polling_loops) {
+                polling_loop.join();
+            }
+            _merging_running.store(false, std::memory_order_relaxed);
+            _merging_loop.join();
+        }
 
-                // pack the fill bits as 16 bits values for sending to the Opal Kelly
-                uint16_t pack = 0;
-                std::size_t pack_index = 0;
+        /// size returns the number of cameras.
+        std::size_t size() const {
+            return _sources.size();
+        }
 
-                for (auto fill_iterator = fill.begin(); fill_iterator != fill.end(); ++fill_iterator) {
-                    if (*fill_iterator) {
-                        pack &= ~(1 << pack_index);
-                    } else {
-                        pack |= 1 << pack_index;
-                    }
+        /// camera returns the camera with the given index, to trigger it or change its biases.
+        opal_kelly_atis_sepia::camera& camera(std::size_t index) {
+            return *_sources.at(index);
+        }
 
-                    if (pack_index == 15) {
-                        _opal_kelly_front_panel.SetWireInValue(0x01, pack);
-                        _opal_kelly_front_panel.SetWireInValue(
-                            0x02, static_cast<uint32_t>((fill_iterator - fill.begin()) / 16));
-                        _opal_kelly_front_panel.UpdateWireIns();
-                        _opal_kelly_front_panel.ActivateTriggerIn(0x40, 3);
-                        pack_index = 0;
-                    } else {
-                        ++pack_index;
+        /// statistics returns a snapshot of the cameras' and the merge's counters.
+        /// It can be called from any thread.
+        multi_camera_statistics statistics() const {
+            multi_camera_statistics statistics;
+            statistics.total = acquisition_statistics();
+            for (std::size_t index = 0; index < _sources.size(); ++index) {
+                statistics.cameras.push_back(_sources[index]->statistics());
+                accumulate(statistics.total, statistics.cameras.back());
+                statistics.connected.push_back(_connected[index].load(std::memory_order_acquire));
+            }
+            statistics.merged_events = _merged_events.load(std::memory_order_relaxed);
+            statistics.late_events = _late_events.load(std::memory_order_relaxed);
+            return statistics;
+        }
+
+        protected:
+        /// disconnect is called by a polling thread when a camera throws.
+        /// Only disconnections are subject to the policy, other errors stop the acquisition.
+        void disconnect(std::size_t index, std::exception_ptr exception) {
+            _connected[index].store(false, std::memory_order_release);
+            auto disconnected = false;
+            try {
+                std::rethrow_exception(exception);
+            } catch (const sepia::device_disconnected&) {
+                disconnected = true;
+            } catch (...) {
+            }
+            if (disconnected && _policy == disconnection_policy::continue_without) {
+                for (std::size_t other_index = 0; other_index < _sources.size(); ++other_index) {
+                    if (_connected[other_index].load(std::memory_order_acquire)) {
+                        return;
                     }
                 }
-                _opal_kelly_front_panel.ActivateTriggerIn(0x40, 4);
+            }
+            _polling_running.store(false, std::memory_order_relaxed);
+            handle_exception_once(exception);
+        }
 
-                // define wether the pixels outside the selection are disabled, or wether the ones inside are
-                _opal_kelly_front_panel.SetWireInValue(
-                    0x00, _parameter->get_boolean({"selection_is_region_of_interest"}) ? 1 << 9 : 0, 1 << 9);
-                _opal_kelly_front_panel.UpdateWireIns();
+        /// handle_exception_once forwards the first exception of the acquisition to the handler.
+        void handle_exception_once(std::exception_ptr exception) {
+            if (!_exception_handled.exchange(true)) {
+                _handle_exception(exception);
+            }
+        }
 
-                // define which part of the pixels the selection is applied to
-                if (_parameter->get_string({"apply_selection_to"}) == "change_detection"
-                    || _parameter->get_string({"apply_selection_to"}) == "change_detection_and_exposure_measurement") {
-                    _opal_kelly_front_panel.SetWireInValue(0x00, 1 << 4, 1 << 4);
-                    _opal_kelly_front_panel.UpdateWireIns();
+        /// merge delivers the cameras' events in timestamp order until the multi-camera is destroyed.
+        void merge() {
+            const auto maximum_t = std::numeric_limits<uint64_t>::max();
+            std::vector<tagged_atis_event> tagged_events;
+            tagged_events.reserve(1 << 16);
+            std::vector<span<const sepia::atis_event>> spans(_sources.size());
+            std::vector<std::size_t> positions(_sources.size());
+            std::vector<std::pair<uint64_t, std::size_t>> heap;
+            heap.reserve(_sources.size());
+            const auto later = [](const std::pair<uint64_t, std::size_t>& first,
+                                  const std::pair<uint64_t, std::size_t>& second) { return first > second; };
+            uint64_t previous_t = 0;
+            while (_merging_running.load(std::memory_order_relaxed)) {
+                // the watermarks are read before the FIFOs, so that the events they cover are readable
+                auto minimum_watermark = maximum_t;
+                uint64_t maximum_watermark = 0;
+                for (std::size_t index = 0; index < _sources.size(); ++index) {
+                    const auto watermark = _sources[index]->watermark();
+                    maximum_watermark = std::max(maximum_watermark, watermark);
+                    if (_connected[index].load(std::memory_order_acquire)) {
+                        minimum_watermark = std::min(minimum_watermark, watermark);
+                    }
                 }
-                if (_parameter->get_string({"apply_selection_to"}) == "exposure_measurement"
-                    || _parameter->get_string({"apply_selection_to"}) == "change_detection_and_exposure_measurement") {
-                    _opal_kelly_front_panel.SetWireInValue(0x00, 1 << 3, 1 << 3);
-                    _opal_kelly_front_panel.UpdateWireIns();
+                const auto limit = minimum_watermark == maximum_t ?
+                                       maximum_t :
+                                       std::max(
+                                           minimum_watermark,
+                                           maximum_watermark > _lateness ? maximum_watermark - _lateness : 0);
+                heap.clear();
+                for (std::size_t index = 0; index < _sources.size(); ++index) {
+                    spans[index] = _sources[index]->fifo().readable();
+                    positions[index] = 0;
+                    if (!spans[index].empty()) {
+                        heap.emplace_back(spans[index][0].t, index);
+                    }
                 }
-            }
-
-            // close the biases and selection settings
-            _opal_kelly_front_panel.SetWireInValue(0x00, 0, 1 << 5);
-            _opal_kelly_front_panel.UpdateWireIns();
+                std::make_heap(heap.begin(), heap.end(), later);
+                while (!heap.empty() && heap.front().first <= limit) {
+                    std::pop_heap(heap.begin(), heap.end(), later);
+                    const auto index = heap.back().second;
+                    heap.pop_back();
 
-            // load the exposure measurement trigger
-            if (_parameter->get_string({"exposure_measurement_trigger"}) == "change_detection") {
-                _opal_kelly_front_panel.SetWireInValue(0x00, 1 << 0, 1 << 0);
-                _opal_kelly_front_panel.UpdateWireIns();
-            } else if (_parameter->get_string({"exposure_measurement_trigger"}) == "sequential") {
-                _opal_kelly_front_panel.SetWireInValue(0x00, 1 << 1, 1 << 1);
-                _opal_kelly_front_panel.UpdateWireIns();
+                    // deliver the camera's events until another camera has an earlier one
+                    const auto next_t = std::min(heap.empty() ? maximum_t : heap.front().first, limit);
+                    auto& events = spans[index];
+                    auto& position = positions[index];
+                    do {
+                        const auto event = events[position];
+                        if (event.t < previous_t) {
+                            _late_events.store(
+                                _late_events.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                        } else {
+                            previous_t = event.t;
+                        }
+                        tagged_events.push_back(tagged_atis_event{
+                            event.t,
+                            event.x,
+                            event.y,
+                            event.is_threshold_crossing,
+                            event.polarity,
+                            static_cast<uint8_t>(index)});
+                        ++position;
+                        if (tagged_events.size() == tagged_events.capacity()) {
+                            deliver(tagged_events);
+                        }
+                    } while (position < events.size() && events[position].t <= next_t);
 
-                if (_parameter->get_string({"apply_selection_to"}) == "change_detection"
-                    || _parameter->get_string({"apply_selection_to"}) == "change_detection_and_exposure_measurement") {
-                    _opal_kelly_front_panel.SetWireInValue(0x00, 1 << 0, 1 << 0);
-                    _opal_kelly_front_panel.UpdateWireIns();
+                    // fetch the next span once the current one is consumed, since the FIFO may wrap around
+                    if (position == events.size()) {
+                        _sources[index]->fifo().release(position);
+                        events = _sources[index]->fifo().readable();
+                        position = 0;
+                    }
+                    if (position < events.size()) {
+                        heap.emplace_back(events[position].t, index);
+                        std::push_heap(heap.begin(), heap.end(), later);
+                    }
+                }
+                deliver(tagged_events);
+                auto delivered = false;
+                for (std::size_t index = 0; index < _sources.size(); ++index) {
+                    if (positions[index] > 0) {
+                        _sources[index]->fifo().release(positions[index]);
+                        delivered = true;
+                    }
+                }
+                if (!delivered) {
+                    std::this_thread::sleep_for(_sleep_duration);
                 }
             }
+        }
 
-            // reset the Atis FIFO
-            _opal_kelly_front_panel.ActivateTriggerIn(0x40, 7);
+        /// deliver calls the events handler with the merged events, and clears them.
+        void deliver(std::vector<tagged_atis_event>& tagged_events) {
+            if (!tagged_events.empty()) {
+                _handle_batch(span<const tagged_atis_event>(tagged_events.data(), tagged_events.size()));
+                _merged_events.store(
+                    _merged_events.load(std::memory_order_relaxed) + tagged_events.size(), std::memory_order_relaxed);
+                tagged_events.clear();
+            }
+        }
 
-            // reset the handlers
-            _opal_kelly_front_panel.ActivateTriggerIn(0x40, 2);
+        HandleBatch _handle_batch;
+        HandleException _handle_exception;
+        const uint64_t _lateness;
+        const disconnection_policy _policy;
+        const std::chrono::milliseconds _sleep_duration;
+        std::vector<std::unique_ptr<camera_source>> _sources;
+        std::unique_ptr<std::atomic_bool[]> _connected;
+        std::atomic_bool _polling_running;
+        std::atomic_bool _merging_running;
+        std::atomic_bool _exception_handled;
+        std::atomic<uint64_t> _merged_events;
+        std::atomic<uint64_t> _late_events;
+        std::vector<std::thread> _polling_loops;
+        std::thread _merging_loop;
+    };
 
-            // enable periodic fake events
-            if (_parameter->get_boolean({"send_fake_event_periodically"})) {
-                _opal_kelly_front_panel.SetWireInValue(0x00, 1 << 12, 1 << 12);
-                _opal_kelly_front_panel.UpdateWireIns();
-            }
+    /// make_multi_camera creates a multi-camera from functors and the serials of the boards.
+    template <typename HandleBatch, typename HandleException>
+    std::unique_ptr<specialized_multi_camera<HandleBatch, HandleException>> make_multi_camera(
+        HandleBatch handle_batch,
+        HandleException handle_exception,
+        std::vector<std::string> serials,
+        std::vector<std::unique_ptr<sepia::unvalidated_parameter>> unvalidated_parameters =
+            std::vector<std::unique_ptr<sepia::unvalidated_parameter>>(),
+        std::chrono::microseconds lateness = std::chrono::milliseconds(10),
+        std::size_t number_of_threads = 1,
+        disconnection_policy policy = disconnection_policy::stop,
+        std::size_t fifo_size = 1 << 24,
+        std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10)) {
+        return sepia::make_unique<specialized_multi_camera<HandleBatch, HandleException>>(
+            std::forward<HandleBatch>(handle_batch),
+            std::forward<HandleException>(handle_exception),
+            std::move(serials),
+            std::vector<std::unique_ptr<front_panel>>(),
+            std::move(unvalidated_parameters),
+            lateness,
+            number_of_threads,
+            policy,
+            fifo_size,
+            sleep_duration);
+    }
 
-            // start the FPGA events reading
-            _opal_kelly_front_panel.SetWireInValue(0x00, 1 << 10, 1 << 10);
-            _opal_kelly_front_panel.UpdateWireIns();
+    /// make_multi_camera creates a multi-camera from functors and opened front panels.
+    template <typename HandleBatch, typename HandleException>
+    std::unique_ptr<specialized_multi_camera<HandleBatch, HandleException>> make_multi_camera(
+        HandleBatch handle_batch,
+        HandleException handle_exception,
+        std::vector<std::unique_ptr<front_panel>> opened_front_panels,
+        std::vector<std::unique_ptr<sepia::unvalidated_parameter>> unvalidated_parameters =
+            std::vector<std::unique_ptr<sepia::unvalidated_parameter>>(),
+        std::chrono::microseconds lateness = std::chrono::milliseconds(10),
+        std::size_t number_of_threads = 1,
+        disconnection_policy policy = disconnection_policy::stop,
+        std::size_t fifo_size = 1 << 24,
+        std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10)) {
+        return sepia::make_unique<specialized_multi_camera<HandleBatch, HandleException>>(
+            std::forward<HandleBatch>(handle_batch),
+            std::forward<HandleException>(handle_exception),
+            std::vector<std::string>(),
+            std::move(opened_front_panels),
+            std::move(unvalidated_parameters),
+            lateness,
+            number_of_threads,
+            policy,
+            fifo_size,
+            sleep_duration);
+    }
 
-            // start the reading loop
-            _acquisition_loop = std::thread([this, serial]() -> void {
-                try {
-                    sepia::atis_event event;
-                    std::vector<uint8_t> events_data((1 << 24) * 4);
-                    std::vector<uint8_t> event_bytes(4);
-                    while (_acquisition_running.load(std::memory_order_relaxed)) {
-                        _opal_kelly_front_panel.UpdateWireOuts();
-                        const auto number_of_events = (_opal_kelly_front_panel.GetWireOutValue(0x21) << 21)
-                                                      + (_opal_kelly_front_panel.GetWireOutValue(0x20) << 5);
-                        if (number_of_events > 1 << 24) {
-                            if (_opal_kelly_front_panel.GetSerialNumber() == serial) {
-                                throw std::runtime_error("Opal Kelly ATIS's FIFO overflow");
-                            } else {
-                                throw sepia::device_disconnected("Opal Kelly ATIS");
-                            }
-                        } else if (number_of_events > 0) {
-                            _opal_kelly_front_panel.ReadFromPipeOut(0xa0, number_of_events * 4, events_data.data());
-                            for (unsigned long event_index = 0; event_index < number_of_events; ++event_index) {
-                                const auto events_data_iterator = events_data.begin() + 4 * event_index;
-                                event_bytes.assign(events_data_iterator, events_data_iterator + 4);
-                                if (event_bytes[3] < 240) {
-                                    event.y = static_cast<uint16_t>(event_bytes[3]);
-                                    event.x = ((static_cast<uint16_t>(event_bytes[1] & 0x20) << 3) | event_bytes[2]);
-                                    if (event.x < 304) {
-                                        event.t =
-                                            _t_offset
-                                            + ((static_cast<int64_t>(event_bytes[1] & 0x1f) << 8) | event_bytes[0]);
-                                        event.is_threshold_crossing = (((event_bytes[1] & 0x40) >> 6) == 0x01);
-                                        event.polarity = (((event_bytes[1] & 0x80) >> 7) == 0x01);
-                                        event.y = 239 - event.y;
-                                        if (!this->push(event)) {
-                                            throw std::runtime_error("Computer's FIFO overflow");
-                                        }
-                                    }
-                                } else if (
-                                    event_bytes[3] == 240
-                                    && ((static_cast<uint16_t>(event_bytes[1] & 0x20) << 3) | event_bytes[2]) == 305
-                                    && ((static_cast<int64_t>(event_bytes[1] & 0x1f) << 8) | event_bytes[0])
-                                           == 0x1555) {
-                                    _t_offset += 0x2000;
-                                }
-                            }
-                        } else {
-                            if (_opal_kelly_front_panel.GetSerialNumber() != serial) {
-                                throw sepia::device_disconnected("Opal Kelly ATIS");
-                            }
-                            std::this_thread::sleep_for(this->_sleep_duration);
-                        }
-                    }
-                } catch (...) {
-                    this->_handle_exception(std::current_exception());
-                }
-            });
+    /// specialized_raw_camera represents an ATIS connected to an Opal Kelly board.
+    /// The pipe-out words are appended to a file without decoding, and can later be converted with
+    /// raw_to_event_stream.
+    template <typename HandleException>
+    class specialized_raw_camera : public camera {
+        public:
+        specialized_raw_camera(
+            const std::string& filename,
+            HandleException handle_exception,
+            std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter,
+            std::string serial,
+            std::chrono::milliseconds sleep_duration,
+            std::unique_ptr<front_panel> opened_front_panel = std::unique_ptr<front_panel>()) :
+            camera(std::move(unvalidated_parameter), serial, sleep_duration, std::move(opened_front_panel)),
+            _handle_exception(std::forward<HandleException>(handle_exception)),
+            _raw_writer(
+                filename,
+                _parameter->get_boolean({"acquisition", "raw", "direct_io"}),
+                _parameter->get_boolean({"acquisition", "raw", "asynchronous_writes"}),
+                static_cast<std::size_t>(_parameter->get_number({"acquisition", "raw", "block_size"})),
+                static_cast<std::size_t>(_parameter->get_number({"acquisition", "raw", "blocks"}))) {
+            start();
         }
-        specialized_camera(const specialized_camera&) = delete;
-        specialized_camera(specialized_camera&&) = default;
-        specialized_camera& operator=(const specialized_camera&) = delete;
-        specialized_camera& operator=(specialized_camera&&) = default;
-        virtual ~specialized_camera() {
-            _acquisition_running.store(false, std::memory_order_relaxed);
-            _acquisition_loop.join();
-            if (_opal_kelly_front_panel.IsOpen()) {
-                _opal_kelly_front_panel.Close();
+        specialized_raw_camera(const specialized_raw_camera&) = delete;
+        specialized_raw_camera(specialized_raw_camera&&) = delete;
+        specialized_raw_camera& operator=(const specialized_raw_camera&) = delete;
+        specialized_raw_camera& operator=(specialized_raw_camera&&) = delete;
+        virtual ~specialized_raw_camera() {
+            stop();
+            try {
+                _raw_writer.close();
+            } catch (...) {
+                this->_handle_exception(std::current_exception());
             }
         }
-        virtual void trigger() override {
-            _opal_kelly_front_panel.SetWireInValue(0x00, 1 << 6, 1 << 6);
-            _opal_kelly_front_panel.UpdateWireIns();
-            _opal_kelly_front_panel.SetWireInValue(0x00, 0 << 6, 1 << 6);
-            _opal_kelly_front_panel.UpdateWireIns();
-        }
 
         protected:
-        std::unique_ptr<sepia::parameter> _parameter;
-        std::atomic_bool _acquisition_running;
-        OpalKellyLegacy::okCFrontPanel _opal_kelly_front_panel;
-        std::thread _acquisition_loop;
-        uint64_t _t_offset;
+        virtual void handle_words(
+            const uint8_t* data,
+            std::size_t number_of_words,
+            std::chrono::steady_clock::time_point) override {
+            _raw_writer.write(data, number_of_words * 4);
+        }
+
+        virtual void handle_acquisition_exception(std::exception_ptr exception) override {
+            this->_handle_exception(exception);
+        }
+
+        HandleException _handle_exception;
+        raw_writer _raw_writer;
     };
 
-    /// make_camera creates a camera from functors.
-    template <typename HandleEvent, typename HandleException>
-    std::unique_ptr<specialized_camera<HandleEvent, HandleException>> make_camera(
-        HandleEvent handle_event,
+    /// make_raw_camera creates a camera writing raw words to a file.
+    template <typename HandleException>
+    std::unique_ptr<specialized_raw_camera<HandleException>> make_raw_camera(
+        const std::string& filename,
         HandleException handle_exception,
         std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter =
             std::unique_ptr<sepia::unvalidated_parameter>(),
-        std::size_t fifo_size = 1 << 24,
         std::string serial = std::string(),
         std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10)) {
-        return sepia::make_unique<specialized_camera<HandleEvent, HandleException>>(
-            std::forward<HandleEvent>(handle_event),
+        return sepia::make_unique<specialized_raw_camera<HandleException>>(
+            filename,
             std::forward<HandleException>(handle_exception),
             std::move(unvalidated_parameter),
-            fifo_size,
             serial,
             sleep_duration);
     }
+
+    /// make_raw_camera creates a camera writing raw words to a file from an opened front panel.
+    template <typename HandleException>
+    std::unique_ptr<specialized_raw_camera<HandleException>> make_raw_camera(
+        const std::string& filename,
+        HandleException handle_exception,
+        std::unique_ptr<front_panel> opened_front_panel,
+        std::unique_ptr<sepia::unvalidated_parameter> unvalidated_parameter =
+            std::unique_ptr<sepia::unvalidated_parameter>(),
+        std::chrono::milliseconds sleep_duration = std::chrono::milliseconds(10)) {
+        return sepia::make_unique<specialized_raw_camera<HandleException>>(
+            filename,
+            std::forward<HandleException>(handle_exception),
+            std::move(unvalidated_parameter),
+            std::string(),
+            sleep_duration,
+            std::move(opened_front_panel));
+    }
+
+    /// raw_to_event_stream decodes a file written by a raw camera, and writes the events to an Event Stream file.
+    /// The decoding rules are those of the acquisition loop (out-of-range words, overflow markers and y flip).
+    /// The number of written events is returned.
+    inline std::size_t raw_to_event_stream(const std::string& raw_filename, const std::string& event_stream_filename) {
+        auto raw_stream = sepia::filename_to_ifstream(raw_filename);
+        sepia::write<sepia::type::atis> write(
+            sepia::filename_to_ofstream(event_stream_filename), camera::width(), camera::height());
+        std::vector<uint8_t> data(1 << 22);
+        std::vector<sepia::atis_event> events(data.size() / 4);
+        uint64_t t_offset = 0;
+        std::size_t number_of_events = 0;
+        for (;;) {
+            raw_stream->read(reinterpret_cast<char*>(data.data()), data.size());
+            const auto number_of_words = static_cast<std::size_t>(raw_stream->gcount()) / 4;
+            if (number_of_words == 0) {
+                break;
+            }
+            const auto number_of_decoded_events = decode(data.data(), number_of_words, t_offset, events.data());
+            for (std::size_t index = 0; index < number_of_decoded_events; ++index) {
+                write(events[index]);
+            }
+            number_of_events += number_of_decoded_events;
+        }
+        return number_of_events;
+    }
 }
@@ -0,0 +1,20 @@
+#include "opal_kelly_atis_sepia.hpp"
+
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Syntax: ./raw_to_es /path/to/input.raw /path/to/output.es\n"
+                     "    the input file must have been written by an Opal Kelly ATIS raw camera"
+                  << std::endl;
+        return 1;
+    }
+    try {
+        const auto number_of_events = opal_kelly_atis_sepia::raw_to_event_stream(argv[1], argv[2]);
+        std::cout << number_of_events << " events written to '" << argv[2] << "'" << std::endl;
+    } catch (const std::exception& exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
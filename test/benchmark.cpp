@@ -0,0 +1,373 @@
+#include "../source/opal_kelly_atis_sepia.hpp"
+
+#include <iostream>
+#include <random>
+
+/// mix describes the composition of synthetic pipe-out words, in words per thousand.
+struct mix {
+    std::string name;
+    uint32_t threshold_crossings;
+    uint32_t markers;
+    uint32_t out_of_range;
+};
+
+/// synthetic_words generates pipe-out bytes following a mix.
+/// The number of words is padded to a multiple of 32 with out-of-range words.
+std::vector<uint8_t> synthetic_words(const mix& selected_mix, std::size_t number_of_words) {
+    std::mt19937 engine(42);
+    std::uniform_int_distribution<uint32_t> kind_distribution(0, 999);
+    std::uniform_int_distribution<uint32_t> word_distribution;
+    std::vector<uint8_t> data;
+    data.reserve(number_of_words * 4 + 128);
+    for (std::size_t index = 0; index < number_of_words || index % 32 != 0; ++index) {
+        auto word = word_distribution(engine);
+        const auto kind = kind_distribution(engine);
+        if (index >= number_of_words) {
+            word = 0xffffffff;
+        } else if (kind < selected_mix.markers) {
+            word = 0xf0313555;
+        } else if (kind < selected_mix.markers + selected_mix.out_of_range) {
+            word |= 0xf0000000;
+        } else {
+            word = (word % 240) << 24 | (((word >> 8) % 304) & 0xff) << 16 | (((word >> 8) % 304) & 0x100) << 5
+                   | (word & 0x9fff)
+                   | (kind < selected_mix.markers + selected_mix.out_of_range + selected_mix.threshold_crossings ?
+                          0x4000 :
+                          0);
+        }
+        for (auto shift = 0; shift < 32; shift += 8) {
+            data.push_back(static_cast<uint8_t>(word >> shift));
+        }
+    }
+    return data;
+}
+
+/// instruction_set_name returns a printable name for an instruction set.
+std::string instruction_set_name(opal_kelly_atis_sepia::instruction_set selected_instruction_set) {
+    switch (selected_instruction_set) {
+        case opal_kelly_atis_sepia::instruction_set::scalar:
+            return "scalar";
+        case opal_kelly_atis_sepia::instruction_set::sse2:
+            return "sse2";
+        case opal_kelly_atis_sepia::instruction_set::avx2:
+            return "avx2";
+    }
+    return "unknown";
+}
+
+/// nanoseconds_since returns the time elapsed since a time point in nanoseconds.
+double nanoseconds_since(std::chrono::steady_clock::time_point time_reference) {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - time_reference)
+            .count());
+}
+
+/// measure_decode measures the decoder throughput with a decode mode, and writes a JSON entry.
+/// The best of several repetitions is reported, to mitigate scheduling noise.
+template <typename Mode>
+void measure_decode(
+    const std::string& mode_name,
+    const mix& selected_mix,
+    const std::vector<uint8_t>& data,
+    opal_kelly_atis_sepia::instruction_set selected_instruction_set,
+    bool first,
+    std::ostream& output) {
+    std::vector<typename Mode::event> events(data.size() / 4);
+    std::size_t number_of_events = 0;
+    auto duration = std::numeric_limits<double>::infinity();
+    for (std::size_t repetition = 0; repetition < 10; ++repetition) {
+        uint64_t t_offset = 0;
+        const auto time_reference = std::chrono::steady_clock::now();
+        number_of_events = opal_kelly_atis_sepia::decode<Mode>(
+            data.data(), data.size() / 4, t_offset, events.data(), selected_instruction_set);
+        duration = std::min(duration, nanoseconds_since(time_reference));
+    }
+    std::cout << "decode " << selected_mix.name << " " << mode_name << " "
+              << instruction_set_name(selected_instruction_set) << ": " << number_of_events / duration * 1e3
+              << " Mev/s, " << duration / (data.size() / 4) << " ns/word" << std::endl;
+    output << (first ? "\n" : ",\n") << "        {\"mix\": \"" << selected_mix.name << "\", \"mode\": \"" << mode_name
+           << "\", \"instruction_set\": \"" << instruction_set_name(selected_instruction_set)
+           << "\", \"event_bytes\": " << sizeof(typename Mode::event) << ", \"words\": " << data.size() / 4
+           << ", \"events\": " << number_of_events << ", \"events_per_second\": " << number_of_events / duration * 1e9
+           << ", \"nanoseconds_per_event\": " << duration / number_of_events
+           << ", \"nanoseconds_per_word\": " << duration / (data.size() / 4) << "}";
+}
+
+/// benchmark_decode measures the decoder throughput with each instruction set, decode mode and mix.
+void benchmark_decode(const std::vector<mix>& mixes, std::ostream& output) {
+    std::vector<opal_kelly_atis_sepia::instruction_set> instruction_sets{
+        opal_kelly_atis_sepia::instruction_set::scalar};
+    if (opal_kelly_atis_sepia::best_instruction_set() != opal_kelly_atis_sepia::instruction_set::scalar) {
+        instruction_sets.push_back(opal_kelly_atis_sepia::instruction_set::sse2);
+    }
+    if (opal_kelly_atis_sepia::best_instruction_set() == opal_kelly_atis_sepia::instruction_set::avx2) {
+        instruction_sets.push_back(opal_kelly_atis_sepia::instruction_set::avx2);
+    }
+    const std::size_t number_of_words = 1 << 22;
+    output << "    \"decode\": [";
+    auto first = true;
+    for (const auto& selected_mix : mixes) {
+        const auto data = synthetic_words(selected_mix, number_of_words);
+        for (const auto selected_instruction_set : instruction_sets) {
+            measure_decode<opal_kelly_atis_sepia::atis_mode>(
+                "atis", selected_mix, data, selected_instruction_set, first, output);
+            first = false;
+            measure_decode<opal_kelly_atis_sepia::dvs_mode>(
+                "dvs", selected_mix, data, selected_instruction_set, first, output);
+            measure_decode<opal_kelly_atis_sepia::exposure_mode>(
+                "exposure", selected_mix, data, selected_instruction_set, first, output);
+            measure_decode<opal_kelly_atis_sepia::decode_mode<sepia::atis_event, true, true, false>>(
+                "atis_native_y", selected_mix, data, selected_instruction_set, first, output);
+            measure_decode<opal_kelly_atis_sepia::compact_mode>(
+                "compact", selected_mix, data, selected_instruction_set, first, output);
+        }
+    }
+    output << "\n    ],\n";
+}
+
+/// benchmark_fifo measures the throughput of the camera FIFO between two threads.
+/// The producer either copies batches (push) or decodes in place (writable and commit).
+void benchmark_fifo(std::ostream& output) {
+    const std::size_t fifo_size = 1 << 24;
+    const std::size_t batch_size = 1 << 12;
+    const std::size_t number_of_events = 1 << 27;
+    std::vector<sepia::atis_event> batch(batch_size);
+    for (std::size_t index = 0; index < batch.size(); ++index) {
+        batch[index].t = index;
+        batch[index].x = static_cast<uint16_t>(index % 304);
+        batch[index].y = static_cast<uint16_t>(index % 240);
+    }
+    output << "    \"fifo\": [";
+    auto first = true;
+    for (const auto in_place : {false, true}) {
+        opal_kelly_atis_sepia::batch_fifo<sepia::atis_event> fifo(fifo_size);
+        uint64_t checksum = 0;
+        const auto time_reference = std::chrono::steady_clock::now();
+        std::thread consumer([&]() {
+            std::size_t consumed = 0;
+            while (consumed < number_of_events) {
+                const auto events = fifo.readable();
+                if (events.empty()) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (const auto event : events) {
+                    checksum += event.t;
+                }
+                consumed += events.size();
+                fifo.release(events.size());
+            }
+        });
+        for (std::size_t produced = 0; produced < number_of_events;) {
+            if (in_place) {
+                const auto events = fifo.writable();
+                if (events.empty()) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const auto size = std::min(events.size(), std::min(batch_size, number_of_events - produced));
+                std::copy(batch.begin(), batch.begin() + size, events.begin());
+                fifo.commit(size);
+                produced += size;
+            } else if (fifo.push(opal_kelly_atis_sepia::span<const sepia::atis_event>(batch.data(), batch.size()))) {
+                produced += batch.size();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+        const auto duration = nanoseconds_since(time_reference);
+        const std::string mode(in_place ? "commit" : "push");
+        std::cout << "fifo " << mode << ": " << number_of_events / duration * 1e3 << " Mev/s (checksum " << checksum
+                  << ")" << std::endl;
+        output << (first ? "\n" : ",\n") << "        {\"mode\": \"" << mode << "\", \"fifo_size\": " << fifo_size
+               << ", \"batch_size\": " << batch_size << ", \"events\": " << number_of_events
+               << ", \"events_per_second\": " << number_of_events / duration * 1e9
+               << ", \"nanoseconds_per_event\": " << duration / number_of_events << "}";
+        first = false;
+    }
+    output << "\n    ],\n";
+}
+
+/// paced_front_panel releases fixed-size chunks of words at a fixed interval, and remembers when each chunk was
+/// released.
+class paced_front_panel : public opal_kelly_atis_sepia::front_panel {
+    public:
+    paced_front_panel(
+        const std::vector<uint8_t>& data,
+        std::size_t words_per_chunk,
+        std::chrono::microseconds interval,
+        std::vector<std::chrono::steady_clock::time_point>& release_times) :
+        _data(data),
+        _words_per_chunk(words_per_chunk),
+        _interval(interval),
+        _release_times(release_times),
+        _started(false),
+        _released_chunks(0),
+        _offset(0),
+        _available_words(0) {}
+    paced_front_panel(const paced_front_panel&) = delete;
+    paced_front_panel(paced_front_panel&&) = delete;
+    paced_front_panel& operator=(const paced_front_panel&) = delete;
+    paced_front_panel& operator=(paced_front_panel&&) = delete;
+    virtual ~paced_front_panel() {}
+
+    /// exhausted returns true once all the words were read.
+    bool exhausted() const {
+        return _offset.load(std::memory_order_acquire) == _data.size();
+    }
+
+    virtual std::string serial() override {
+        return "paced";
+    }
+    virtual void set_wire_in_value(int32_t, uint32_t, uint32_t) override {}
+    virtual void update_wire_ins() override {}
+    virtual void activate_trigger_in(int32_t, int32_t) override {}
+    virtual void update_wire_outs() override {
+        const auto now = std::chrono::steady_clock::now();
+        if (!_started) {
+            _started = true;
+            _time_reference = now;
+        }
+        while (_released_chunks < _release_times.size()) {
+            const auto release_time = _time_reference + _interval * _released_chunks;
+            if (release_time > now) {
+                break;
+            }
+            _release_times[_released_chunks] = release_time;
+            ++_released_chunks;
+        }
+        _available_words = std::min(_released_chunks * _words_per_chunk, _data.size() / 4)
+                           - _offset.load(std::memory_order_relaxed) / 4;
+    }
+    virtual uint32_t wire_out_value(int32_t address) override {
+        return static_cast<uint32_t>(
+            address == 0x20 ? ((_available_words >> 5) & 0xffff) : (address == 0x21 ? _available_words >> 21 : 0));
+    }
+    virtual void read_from_pipe_out(int32_t, std::size_t size, uint8_t* data) override {
+        const auto offset = _offset.load(std::memory_order_relaxed);
+        size = std::min(size, _data.size() - offset);
+        std::copy(_data.begin() + offset, _data.begin() + offset + size, data);
+        _offset.store(offset + size, std::memory_order_release);
+    }
+
+    protected:
+    const std::vector<uint8_t>& _data;
+    const std::size_t _words_per_chunk;
+    const std::chrono::microseconds _interval;
+    std::vector<std::chrono::steady_clock::time_point>& _release_times;
+    bool _started;
+    std::chrono::steady_clock::time_point _time_reference;
+    std::size_t _released_chunks;
+    std::atomic<std::size_t> _offset;
+    std::size_t _available_words;
+};
+
+/// benchmark_latency measures the delay between the release of words by a paced front panel and the call to the
+/// handler with the corresponding events.
+void benchmark_latency(const mix& selected_mix, std::ostream& output) {
+    const std::size_t words_per_chunk = 1 << 10;
+    const std::size_t number_of_chunks = 2000;
+    const std::chrono::microseconds interval(250);
+    const auto data = synthetic_words(selected_mix, words_per_chunk * number_of_chunks);
+    std::vector<std::size_t> events_before_chunk(number_of_chunks + 1, 0);
+    {
+        std::vector<sepia::atis_event> events(words_per_chunk);
+        uint64_t t_offset = 0;
+        for (std::size_t index = 0; index < number_of_chunks; ++index) {
+            events_before_chunk[index + 1] =
+                events_before_chunk[index]
+                + opal_kelly_atis_sepia::decode(
+                    data.data() + index * words_per_chunk * 4, words_per_chunk, t_offset, events.data());
+        }
+    }
+    const std::vector<std::pair<std::string, std::string>> configurations{
+        {"fixed", "{\"acquisition\": {\"polling\": {\"policy\": \"fixed\"}}}"},
+        {"adaptive", "{\"acquisition\": {\"polling\": {\"policy\": \"adaptive\", \"latency_target\": 100}}}"},
+        {"pipelined_adaptive",
+         "{\"acquisition\": {\"pipelined\": true, \"transfer_buffer_words\": 4096, \"polling\": {\"policy\": "
+         "\"adaptive\", \"latency_target\": 100}}}"},
+    };
+    output << "    \"latency\": [";
+    auto first = true;
+    for (const auto& configuration : configurations) {
+        const auto parameter_filename = "benchmark_" + configuration.first + ".json";
+        {
+            std::ofstream parameter_file(parameter_filename);
+            parameter_file << configuration.second;
+        }
+        std::vector<std::chrono::steady_clock::time_point> release_times(number_of_chunks);
+        std::vector<double> latencies;
+        latencies.reserve(events_before_chunk.back());
+        std::size_t number_of_events = 0;
+        std::atomic_bool failed(false);
+        double poll_rate = 0;
+        {
+            auto front_panel = sepia::make_unique<paced_front_panel>(data, words_per_chunk, interval, release_times);
+            const auto paced_front_panel_pointer = front_panel.get();
+            auto camera = opal_kelly_atis_sepia::make_batch_camera(
+                [&](opal_kelly_atis_sepia::span<const sepia::atis_event> events) {
+                    const auto chunk = static_cast<std::size_t>(
+                        std::upper_bound(events_before_chunk.begin(), events_before_chunk.end(), number_of_events)
+                        - events_before_chunk.begin() - 1);
+                    latencies.push_back(nanoseconds_since(release_times[chunk]));
+                    number_of_events += events.size();
+                },
+                [&](std::exception_ptr exception) {
+                    try {
+                        std::rethrow_exception(exception);
+                    } catch (const std::exception& caught_exception) {
+                        std::cerr << configuration.first << ": " << caught_exception.what() << std::endl;
+                    }
+                    failed.store(true, std::memory_order_release);
+                },
+                std::move(front_panel),
+                sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+                1 << 24,
+                std::chrono::milliseconds(1));
+            while (!paced_front_panel_pointer->exhausted() && !failed.load(std::memory_order_acquire)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            poll_rate = camera->poll_rate();
+        }
+        std::remove(parameter_filename.c_str());
+        std::sort(latencies.begin(), latencies.end());
+        const auto percentile = [&](double ratio) {
+            return latencies.empty() ? 0.0 : latencies[static_cast<std::size_t>(ratio * (latencies.size() - 1))];
+        };
+        std::cout << "latency " << configuration.first << ": " << percentile(0.5) / 1e3 << " us median, "
+                  << percentile(0.99) / 1e3 << " us p99, " << poll_rate << " polls per second" << std::endl;
+        output << (first ? "\n" : ",\n") << "        {\"configuration\": \"" << configuration.first
+               << "\", \"mix\": \"" << selected_mix.name << "\", \"events\": " << number_of_events
+               << ", \"batches\": " << latencies.size() << ", \"polls_per_second\": " << poll_rate
+               << ", \"median_nanoseconds\": " << percentile(0.5) << ", \"p90_nanoseconds\": " << percentile(0.9)
+               << ", \"p99_nanoseconds\": " << percentile(0.99) << ", \"maximum_nanoseconds\": " << percentile(1.0)
+               << "}";
+        first = false;
+    }
+    output << "\n    ]\n";
+}
+
+int main(int argc, char* argv[]) {
+    const std::string results_filename(argc > 1 ? argv[1] : "benchmark.json");
+    const std::vector<mix> mixes{
+        {"dvs", 0, 1, 0},
+        {"exposure_heavy", 800, 1, 0},
+        {"dense_markers", 100, 250, 0},
+        {"out_of_range", 100, 1, 500},
+    };
+    std::ofstream output(results_filename);
+    if (!output.good()) {
+        std::cerr << "'" << results_filename << "' could not be open for writing" << std::endl;
+        return 1;
+    }
+    output << "{\n    \"best_instruction_set\": \""
+           << instruction_set_name(opal_kelly_atis_sepia::best_instruction_set()) << "\",\n";
+    benchmark_decode(mixes, output);
+    benchmark_fifo(output);
+    benchmark_latency(mixes.front(), output);
+    output << "}\n";
+    std::cout << "results written to '" << results_filename << "'" << std::endl;
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include "../source/opal_kelly_atis_sepia.hpp"
+
+#include <iostream>
+#include <random>
+
+/// reference_decode is the byte-oriented decoder used by the acquisition loop before the batch decoder.
+std::vector<sepia::atis_event> reference_decode(const std::vector<uint8_t>& data, uint64_t& t_offset) {
+    std::vector<sepia::atis_event> events;
+    sepia::atis_event event;
+    for (std::size_t index = 0; index < data.size() / 4; ++index) {
+        const auto event_bytes = data.data() + 4 * index;
+        if (event_bytes[3] < 240) {
+            event.y = static_cast<uint16_t>(event_bytes[3]);
+            event.x = ((static_cast<uint16_t>(event_bytes[1] & 0x20) << 3) | event_bytes[2]);
+            if (event.x < 304) {
+                event.t = t_offset + ((static_cast<int64_t>(event_bytes[1] & 0x1f) << 8) | event_bytes[0]);
+                event.is_threshold_crossing = (((event_bytes[1] & 0x40) >> 6) == 0x01);
+                event.polarity = (((event_bytes[1] & 0x80) >> 7) == 0x01);
+                event.y = 239 - event.y;
+                events.push_back(event);
+            }
+        } else if (
+            event_bytes[3] == 240 && ((static_cast<uint16_t>(event_bytes[1] & 0x20) << 3) | event_bytes[2]) == 305
+            && ((static_cast<int64_t>(event_bytes[1] & 0x1f) << 8) | event_bytes[0]) == 0x1555) {
+            t_offset += 0x2000;
+        }
+    }
+    return events;
+}
+
+/// equal compares events field by field.
+bool equal(const std::vector<sepia::atis_event>& events, const std::vector<sepia::atis_event>& other_events) {
+    return events.size() == other_events.size()
+           && std::equal(
+               events.begin(),
+               events.end(),
+               other_events.begin(),
+               [](sepia::atis_event event, sepia::atis_event other_event) {
+                   return event.t == other_event.t && event.x == other_event.x && event.y == other_event.y
+                          && event.is_threshold_crossing == other_event.is_threshold_crossing
+                          && event.polarity == other_event.polarity;
+               });
+}
+
+/// same compares a decoded ATIS event with a reference event.
+bool same(const sepia::atis_event& event, const sepia::atis_event& reference_event) {
+    return event.t == reference_event.t && event.x == reference_event.x && event.y == reference_event.y
+           && event.is_threshold_crossing == reference_event.is_threshold_crossing
+           && event.polarity == reference_event.polarity;
+}
+
+/// same compares a decoded DVS event with a reference event.
+bool same(const sepia::dvs_event& event, const sepia::atis_event& reference_event) {
+    return event.t == reference_event.t && event.x == reference_event.x && event.y == reference_event.y
+           && event.is_increase == reference_event.polarity;
+}
+
+/// same compares a decoded compact ATIS event with a reference event.
+bool same(const opal_kelly_atis_sepia::compact_atis_event& event, const sepia::atis_event& reference_event) {
+    return same(opal_kelly_atis_sepia::unpack(event), reference_event);
+}
+
+/// mode_matches decodes words with a decode mode, and compares the events with the reference events selected and
+/// flipped as the mode requires. The events of the discarded type must be counted.
+template <typename Mode>
+bool mode_matches(
+    const std::vector<uint8_t>& data,
+    std::size_t number_of_words,
+    opal_kelly_atis_sepia::instruction_set selected_instruction_set,
+    const std::vector<sepia::atis_event>& reference_events,
+    uint64_t reference_t_offset) {
+    std::vector<sepia::atis_event> expected_events;
+    for (auto event : reference_events) {
+        if (Mode::keep(event.is_threshold_crossing ? 1 : 0)) {
+            if (!Mode::flips_y()) {
+                event.y = 239 - event.y;
+            }
+            expected_events.push_back(event);
+        }
+    }
+    uint64_t t_offset = 0x2000;
+    std::size_t number_of_discarded_events = 0;
+    std::vector<typename Mode::event> events(number_of_words);
+    events.resize(opal_kelly_atis_sepia::decode<Mode>(
+        data.data(),
+        number_of_words,
+        t_offset,
+        events.data(),
+        selected_instruction_set,
+        &number_of_discarded_events));
+    return t_offset == reference_t_offset && events.size() == expected_events.size()
+           && number_of_discarded_events == reference_events.size() - expected_events.size()
+           && std::equal(
+               events.begin(),
+               events.end(),
+               expected_events.begin(),
+               [](const typename Mode::event& event, const sepia::atis_event& expected_event) {
+                   return same(event, expected_event);
+               });
+}
+
+/// synthetic_words generates pipe-out bytes mixing events, overflow markers and out-of-range words.
+std::vector<uint8_t> synthetic_words(std::mt19937& engine, std::size_t number_of_words) {
+    std::vector<uint8_t> data;
+    data.reserve(number_of_words * 4);
+    std::uniform_int_distribution<uint32_t> kind_distribution(0, 9);
+    std::uniform_int_distribution<uint32_t> word_distribution;
+    for (std::size_t index = 0; index < number_of_words; ++index) {
+        auto word = word_distribution(engine);
+        switch (kind_distribution(engine)) {
+            case 0:
+                word = 0xf0313555 | (word & 0xc000);
+                break;
+            case 1:
+            case 2:
+                break;
+            default:
+                word = (word % 240) << 24 | (((word >> 8) % 304) & 0xff) << 16 | (((word >> 8) % 304) & 0x100) << 5
+                       | (word & 0xdfff);
+                break;
+        }
+        for (auto shift = 0; shift < 32; shift += 8) {
+            data.push_back(static_cast<uint8_t>(word >> shift));
+        }
+    }
+    return data;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<opal_kelly_atis_sepia::instruction_set> instruction_sets{
+        opal_kelly_atis_sepia::instruction_set::scalar};
+    if (opal_kelly_atis_sepia::best_instruction_set() != opal_kelly_atis_sepia::instruction_set::scalar) {
+        instruction_sets.push_back(opal_kelly_atis_sepia::instruction_set::sse2);
+    }
+    if (opal_kelly_atis_sepia::best_instruction_set() == opal_kelly_atis_sepia::instruction_set::avx2) {
+        instruction_sets.push_back(opal_kelly_atis_sepia::instruction_set::avx2);
+    }
+    std::mt19937 engine(42);
+    for (std::size_t number_of_words : {0, 1, 3, 4, 7, 8, 9, 31, 32, 33, 1000, 1 << 16, (1 << 16) + 5}) {
+        const auto data = synthetic_words(engine, number_of_words);
+        uint64_t expected_t_offset = 0x2000;
+        const auto expected_events = reference_decode(data, expected_t_offset);
+        for (const auto selected_instruction_set : instruction_sets) {
+            uint64_t t_offset = 0x2000;
+            std::vector<sepia::atis_event> events(number_of_words);
+            events.resize(opal_kelly_atis_sepia::decode(
+                data.data(), number_of_words, t_offset, events.data(), selected_instruction_set));
+            if (t_offset != expected_t_offset || !equal(events, expected_events)) {
+                std::cerr << "instruction set " << static_cast<int>(selected_instruction_set)
+                          << " does not match the reference decoder for " << number_of_words << " words" << std::endl;
+                return 1;
+            }
+            const auto modes_match =
+                mode_matches<opal_kelly_atis_sepia::dvs_mode>(
+                    data, number_of_words, selected_instruction_set, expected_events, expected_t_offset)
+                && mode_matches<opal_kelly_atis_sepia::exposure_mode>(
+                    data, number_of_words, selected_instruction_set, expected_events, expected_t_offset)
+                && mode_matches<opal_kelly_atis_sepia::decode_mode<sepia::atis_event, true, true, false>>(
+                    data, number_of_words, selected_instruction_set, expected_events, expected_t_offset)
+                && mode_matches<opal_kelly_atis_sepia::compact_mode>(
+                    data, number_of_words, selected_instruction_set, expected_events, expected_t_offset);
+            if (!modes_match) {
+                std::cerr << "instruction set " << static_cast<int>(selected_instruction_set)
+                          << " does not match the reference decoder in a specialised mode for " << number_of_words
+                          << " words" << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "decode: " << instruction_sets.size() << " instruction sets match the reference decoder in 5 modes"
+              << std::endl;
+    return 0;
+}
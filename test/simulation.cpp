@@ -0,0 +1,1499 @@
+#include "../source/opal_kelly_atis_sepia.hpp"
+
+#include <iostream>
+#include <poll.h>
+#include <random>
+
+/// synthetic_words generates pipe-out bytes mixing events and overflow markers.
+/// The number of words is padded to a multiple of 32 with out-of-range words.
+std::vector<uint8_t> synthetic_words(std::size_t number_of_words) {
+    std::mt19937 engine(42);
+    std::uniform_int_distribution<uint32_t> word_distribution;
+    std::vector<uint8_t> data;
+    data.reserve(number_of_words * 4 + 128);
+    for (std::size_t index = 0; index < number_of_words || index % 32 != 0; ++index) {
+        auto word = word_distribution(engine);
+        if (index >= number_of_words) {
+            word = 0xffffffff;
+        } else if (index % 100 == 0) {
+            word = 0xf0313555;
+        } else {
+            word = (word % 240) << 24 | (((word >> 8) % 304) & 0xff) << 16 | (((word >> 8) % 304) & 0x100) << 5
+                   | (word & 0xdfff);
+        }
+        for (auto shift = 0; shift < 32; shift += 8) {
+            data.push_back(static_cast<uint8_t>(word >> shift));
+        }
+    }
+    return data;
+}
+
+/// acquire runs a camera on a replay front panel and returns false if the events do not match the data.
+/// If batch is true, the camera uses a batch handler instead of an event handler.
+bool acquire(
+    const std::string& name,
+    const std::string& json_parameter,
+    const std::vector<uint8_t>& data,
+    opal_kelly_atis_sepia::replay_front_panel::pacing pacing,
+    std::size_t words_per_poll,
+    bool batch) {
+    std::vector<sepia::atis_event> expected_events(data.size() / 4);
+    uint64_t t_offset = 0;
+    expected_events.resize(
+        opal_kelly_atis_sepia::decode_scalar(data.data(), data.size() / 4, t_offset, expected_events.data()));
+    const auto parameter_filename = name + ".json";
+    {
+        std::ofstream parameter_file(parameter_filename);
+        parameter_file << json_parameter;
+    }
+    std::vector<sepia::atis_event> events(expected_events.size());
+    std::atomic<std::size_t> number_of_events(0);
+    std::atomic_bool failed(false);
+    double poll_rate = 0;
+    opal_kelly_atis_sepia::acquisition_statistics statistics;
+    auto drift = 0.0;
+    std::chrono::steady_clock::time_point last_event_host_time;
+    std::chrono::steady_clock::time_point start_time;
+    const auto time_reference = std::chrono::steady_clock::now();
+    {
+        auto handle_exception = [&](std::exception_ptr exception) {
+            try {
+                std::rethrow_exception(exception);
+            } catch (const std::exception& caught_exception) {
+                std::cerr << name << ": " << caught_exception.what() << std::endl;
+            }
+            failed.store(true, std::memory_order_release);
+        };
+        std::unique_ptr<opal_kelly_atis_sepia::camera> camera;
+        if (batch) {
+            camera = opal_kelly_atis_sepia::make_batch_camera(
+                [&](opal_kelly_atis_sepia::span<const sepia::atis_event> batch_events) {
+                    const auto index = number_of_events.load(std::memory_order_relaxed);
+                    if (index + batch_events.size() <= events.size()) {
+                        std::copy(batch_events.begin(), batch_events.end(), events.begin() + index);
+                    }
+                    number_of_events.store(index + batch_events.size(), std::memory_order_release);
+                },
+                handle_exception,
+                sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(data, pacing, words_per_poll),
+                sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+                1 << 24,
+                std::chrono::milliseconds(1));
+        } else {
+            camera = opal_kelly_atis_sepia::make_camera(
+                [&](sepia::atis_event event) {
+                    const auto index = number_of_events.load(std::memory_order_relaxed);
+                    if (index < events.size()) {
+                        events[index] = event;
+                    }
+                    number_of_events.store(index + 1, std::memory_order_release);
+                },
+                handle_exception,
+                sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(data, pacing, words_per_poll),
+                sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+                1 << 24,
+                std::chrono::milliseconds(1));
+        }
+        start_time = std::chrono::steady_clock::now();
+        while (number_of_events.load(std::memory_order_acquire) < expected_events.size()
+               && !failed.load(std::memory_order_acquire)
+               && std::chrono::steady_clock::now() - time_reference < std::chrono::seconds(30)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        poll_rate = camera->poll_rate();
+        do {
+            statistics = camera->statistics();
+        } while (statistics.pushed_events < expected_events.size() && !failed.load(std::memory_order_acquire)
+                 && std::chrono::steady_clock::now() - time_reference < std::chrono::seconds(30));
+        if (camera->host_clock().valid() && !expected_events.empty()) {
+            drift = camera->host_clock().drift();
+            last_event_host_time = camera->host_clock().host_time(expected_events.back().t);
+        }
+    }
+    std::remove(parameter_filename.c_str());
+    if (number_of_events.load(std::memory_order_acquire) != expected_events.size()) {
+        std::cerr << name << ": received " << number_of_events.load() << " events, expected "
+                  << expected_events.size() << std::endl;
+        return false;
+    }
+    {
+        // streaming reads a fill level in several chunks, hence a poll may count several reads
+        const auto streaming = json_parameter.find("\"streaming\"") != std::string::npos;
+        const auto number_of_markers = t_offset / 0x2000;
+        uint64_t number_of_reads = 0;
+        for (const auto count : statistics.read_sizes) {
+            number_of_reads += count;
+        }
+        if (statistics.decoded_events != expected_events.size() || statistics.pushed_events != expected_events.size()
+            || statistics.read_bytes != data.size() || statistics.overflow_markers != number_of_markers
+            || statistics.dropped_words != data.size() / 4 - expected_events.size() - number_of_markers
+            || statistics.reads == 0 || number_of_reads != statistics.reads
+            || statistics.maximum_board_fifo_words == 0 || statistics.maximum_host_fifo_events == 0
+            || (streaming ? statistics.reads <= statistics.polls : statistics.polls < statistics.reads)) {
+            std::cerr << name << ": the statistics do not match the data" << std::endl;
+            return false;
+        }
+    }
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - time_reference);
+    if (pacing == opal_kelly_atis_sepia::replay_front_panel::pacing::real_time) {
+        uint64_t maximum_t = 0;
+        for (const auto event : expected_events) {
+            maximum_t = std::max(maximum_t, event.t);
+        }
+        if (static_cast<uint64_t>(duration.count()) < maximum_t) {
+            std::cerr << name << ": the events were replayed faster than real time" << std::endl;
+            return false;
+        }
+        const auto host_time_error =
+            last_event_host_time - (start_time + std::chrono::microseconds(expected_events.back().t));
+        uint64_t number_of_handler_calls = 0;
+        for (const auto count : statistics.handler_latencies) {
+            number_of_handler_calls += count;
+        }
+        if (std::abs(drift) > 0.05 || host_time_error > std::chrono::milliseconds(50)
+            || host_time_error < -std::chrono::milliseconds(50) || number_of_handler_calls == 0) {
+            std::cerr << name << ": the host clock model does not match the replay (drift " << drift << ", error "
+                      << std::chrono::duration_cast<std::chrono::microseconds>(host_time_error).count() << " us)"
+                      << std::endl;
+            return false;
+        }
+    }
+    for (std::size_t index = 0; index < events.size(); ++index) {
+        if (events[index].t != expected_events[index].t || events[index].x != expected_events[index].x
+            || events[index].y != expected_events[index].y
+            || events[index].is_threshold_crossing != expected_events[index].is_threshold_crossing
+            || events[index].polarity != expected_events[index].polarity) {
+            std::cerr << name << ": event " << index << " does not match" << std::endl;
+            return false;
+        }
+    }
+    std::cout << name << ": " << events.size() << " events in " << duration.count() / 1000 << " ms, " << poll_rate
+              << " polls per second" << std::endl;
+    return true;
+}
+
+/// record runs a raw camera on a replay front panel and returns false if the file does not match the data.
+bool record(const std::string& name, const std::string& json_parameter) {
+    const auto data = synthetic_words(1 << 21);
+    const auto parameter_filename = name + ".json";
+    {
+        std::ofstream parameter_file(parameter_filename);
+        parameter_file << json_parameter;
+    }
+    const auto raw_filename = name + ".raw";
+    std::atomic_bool failed(false);
+    const auto time_reference = std::chrono::steady_clock::now();
+    {
+        auto front_panel = sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(
+            data, opal_kelly_atis_sepia::replay_front_panel::pacing::as_fast_as_possible, 1 << 16);
+        const auto replay_front_panel = front_panel.get();
+        auto camera = opal_kelly_atis_sepia::make_raw_camera(
+            raw_filename,
+            [&](std::exception_ptr exception) {
+                try {
+                    std::rethrow_exception(exception);
+                } catch (const std::exception& caught_exception) {
+                    std::cerr << name << ": " << caught_exception.what() << std::endl;
+                }
+                failed.store(true, std::memory_order_release);
+            },
+            std::move(front_panel),
+            sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+            std::chrono::milliseconds(1));
+        while (!replay_front_panel->exhausted() && !failed.load(std::memory_order_acquire)
+               && std::chrono::steady_clock::now() - time_reference < std::chrono::seconds(30)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    std::remove(parameter_filename.c_str());
+    std::vector<uint8_t> raw_data;
+    {
+        std::ifstream raw_file(raw_filename, std::ifstream::binary);
+        raw_data.assign(std::istreambuf_iterator<char>(raw_file), std::istreambuf_iterator<char>());
+    }
+    if (failed.load(std::memory_order_acquire) || raw_data != data) {
+        std::cerr << name << ": the raw file does not match the pipe-out words" << std::endl;
+        std::remove(raw_filename.c_str());
+        return false;
+    }
+    std::vector<sepia::atis_event> expected_events(data.size() / 4);
+    uint64_t t_offset = 0;
+    const auto number_of_expected_events =
+        opal_kelly_atis_sepia::decode_scalar(data.data(), data.size() / 4, t_offset, expected_events.data());
+    const auto number_of_events = opal_kelly_atis_sepia::raw_to_event_stream(raw_filename, name + ".es");
+    std::remove(raw_filename.c_str());
+    std::remove((name + ".es").c_str());
+    if (number_of_events != number_of_expected_events) {
+        std::cerr << name << ": converted " << number_of_events << " events, expected " << number_of_expected_events
+                  << std::endl;
+        return false;
+    }
+    std::cout << name << ": " << raw_data.size() << " bytes in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - time_reference)
+                     .count()
+              << " ms" << std::endl;
+    return true;
+}
+
+/// recording_front_panel replays words, and records the wire-in updates and trigger-ins sent to the board.
+class recording_front_panel : public opal_kelly_atis_sepia::replay_front_panel {
+    public:
+    recording_front_panel(std::vector<uint8_t> data, std::vector<std::string>& log, std::mutex& log_mutex) :
+        replay_front_panel(std::move(data), pacing::as_fast_as_possible),
+        _log(log),
+        _log_mutex(log_mutex) {
+        _wire_ins.fill(0);
+    }
+    recording_front_panel(const recording_front_panel&) = delete;
+    recording_front_panel(recording_front_panel&&) = delete;
+    recording_front_panel& operator=(const recording_front_panel&) = delete;
+    recording_front_panel& operator=(recording_front_panel&&) = delete;
+    virtual ~recording_front_panel() {}
+
+    virtual void set_wire_in_value(int32_t address, uint32_t value, uint32_t mask) override {
+        _wire_ins.at(static_cast<std::size_t>(address)) =
+            (_wire_ins.at(static_cast<std::size_t>(address)) & ~mask) | (value & mask);
+    }
+    virtual void update_wire_ins() override {
+        std::lock_guard<std::mutex> lock(_log_mutex);
+        _log.push_back(
+            "update " + std::to_string(_wire_ins[0]) + " " + std::to_string(_wire_ins[1]) + " "
+            + std::to_string(_wire_ins[2]) + " " + std::to_string(_wire_ins[3]));
+    }
+    virtual void activate_trigger_in(int32_t address, int32_t bit) override {
+        std::lock_guard<std::mutex> lock(_log_mutex);
+        _log.push_back("trigger " + std::to_string(address) + " " + std::to_string(bit));
+    }
+
+    protected:
+    std::vector<std::string>& _log;
+    std::mutex& _log_mutex;
+    std::array<uint32_t, 4> _wire_ins;
+};
+
+/// board_states returns, for each trigger-in in a log, the last wire-in update before it.
+/// The last wire-in update of the log is appended.
+std::vector<std::string> board_states(const std::vector<std::string>& log) {
+    std::vector<std::string> states;
+    std::string state;
+    for (const auto& entry : log) {
+        if (entry.compare(0, 7, "trigger") == 0) {
+            states.push_back(state + " / " + entry);
+        } else {
+            state = entry;
+        }
+    }
+    states.push_back(state);
+    return states;
+}
+
+/// startup configures cameras with and without merged wire-in updates, and returns false if the board does not
+/// receive the same states before each trigger-in, or if the merged configuration does not save round trips.
+bool startup(const std::string& name) {
+    std::vector<std::vector<std::string>> logs;
+    std::vector<opal_kelly_atis_sepia::startup_report> reports;
+    for (const auto merge : {false, true}) {
+        const auto parameter_filename = name + ".json";
+        {
+            std::ofstream parameter_file(parameter_filename);
+            parameter_file << "{\"startup\": {\"merge_wire_ins\": " << (merge ? "true" : "false")
+                           << "}, \"columns_selection\": [100, 50, 154], \"rows_selection\": [20, 200, 20], "
+                              "\"apply_selection_to\": \"change_detection_and_exposure_measurement\", "
+                              "\"send_fake_event_periodically\": true}";
+        }
+        std::vector<std::string> log;
+        std::mutex log_mutex;
+        std::atomic_bool failed(false);
+        {
+            auto camera = opal_kelly_atis_sepia::make_batch_camera(
+                [](opal_kelly_atis_sepia::span<const sepia::atis_event>) {},
+                [&](std::exception_ptr exception) {
+                    try {
+                        std::rethrow_exception(exception);
+                    } catch (const std::exception& caught_exception) {
+                        std::cerr << name << ": " << caught_exception.what() << std::endl;
+                    }
+                    failed.store(true, std::memory_order_release);
+                },
+                sepia::make_unique<recording_front_panel>(synthetic_words(1 << 10), log, log_mutex),
+                sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+                1 << 16,
+                std::chrono::milliseconds(1));
+            reports.push_back(camera->startup());
+            camera->trigger();
+            const auto polls = camera->statistics().polls;
+            const auto time_reference = std::chrono::steady_clock::now();
+            while (camera->statistics().polls < polls + 2 && !failed.load(std::memory_order_acquire)
+                   && std::chrono::steady_clock::now() - time_reference < std::chrono::seconds(30)) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        std::remove(parameter_filename.c_str());
+        if (failed.load(std::memory_order_acquire)) {
+            return false;
+        }
+        logs.push_back(log);
+    }
+    if (board_states(logs[0]) != board_states(logs[1])) {
+        std::cerr << name << ": the merged updates change the board states seen by trigger-ins" << std::endl;
+        return false;
+    }
+    if (reports[1].wire_in_updates >= reports[0].wire_in_updates
+        || reports[0].wire_in_update_requests != reports[1].wire_in_update_requests
+        || reports[0].trigger_ins != reports[1].trigger_ins) {
+        std::cerr << name << ": the merged configuration sent " << reports[1].wire_in_updates
+                  << " wire-in updates, the sequential one " << reports[0].wire_in_updates << std::endl;
+        return false;
+    }
+    for (const auto& log : logs) {
+        if (log.size() < 3 || log[log.size() - 2] == log[log.size() - 1]
+            || log[log.size() - 1] != log[log.size() - 3]) {
+            std::cerr << name << ": the trigger pulse was not sent to the board" << std::endl;
+            return false;
+        }
+    }
+    std::cout << name << ": " << reports[0].wire_in_updates << " wire-in updates, " << reports[1].wire_in_updates
+              << " when merged, " << reports[0].trigger_ins << " trigger-ins" << std::endl;
+    return true;
+}
+
+/// count_entries returns the number of log entries equal to entry, starting at begin.
+std::size_t count_entries(const std::vector<std::string>& log, std::size_t begin, const std::string& entry) {
+    return static_cast<std::size_t>(
+        std::count(std::next(log.begin(), static_cast<std::ptrdiff_t>(begin)), log.end(), entry));
+}
+
+/// reprogram changes biases and the selection during an acquisition, and returns false if the board does not
+/// receive exactly the changed values.
+bool reprogram(const std::string& name) {
+    std::vector<std::string> log;
+    std::mutex log_mutex;
+    std::atomic_bool failed(false);
+    const auto parameter_filename = name + ".json";
+    {
+        std::ofstream parameter_file(parameter_filename);
+        parameter_file << "{}";
+    }
+    {
+        auto camera = opal_kelly_atis_sepia::make_batch_camera(
+            [](opal_kelly_atis_sepia::span<const sepia::atis_event>) {},
+            [&](std::exception_ptr exception) {
+                try {
+                    std::rethrow_exception(exception);
+                } catch (const std::exception& caught_exception) {
+                    std::cerr << name << ": " << caught_exception.what() << std::endl;
+                }
+                failed.store(true, std::memory_order_release);
+            },
+            sepia::make_unique<recording_front_panel>(synthetic_words(1 << 10), log, log_mutex),
+            sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+            1 << 16,
+            std::chrono::milliseconds(1));
+        const auto changes = [&](const std::function<void()>& change,
+                                 std::size_t expected_dac_writes,
+                                 std::size_t expected_pack_writes) {
+            std::size_t begin = 0;
+            {
+                std::lock_guard<std::mutex> lock(log_mutex);
+                begin = log.size();
+            }
+            change();
+            std::lock_guard<std::mutex> lock(log_mutex);
+            return count_entries(log, begin, "trigger 64 1") == expected_dac_writes
+                   && count_entries(log, begin, "trigger 64 6") == (expected_dac_writes > 0 ? 1 : 0)
+                   && count_entries(log, begin, "trigger 64 3") == expected_pack_writes;
+        };
+        if (!changes([&]() { camera->set_bias("change_detection", "follower", 0x70); }, 1, 0)) {
+            std::cerr << name << ": set_bias did not send exactly one bias" << std::endl;
+            return false;
+        }
+        std::vector<bool> columns(304, true);
+        std::vector<bool> rows(240, true);
+        if (!changes([&]() { camera->set_selection(columns, rows); }, 0, 34)) {
+            std::cerr << name << ": the first selection was not sent entirely" << std::endl;
+            return false;
+        }
+        columns[42] = false;
+        if (!changes([&]() { camera->set_selection(columns, rows); }, 0, 1)) {
+            std::cerr << name << ": the selection change was not sent as a single pack" << std::endl;
+            return false;
+        }
+        const auto update = [&](const std::string& partial_parameter) {
+            {
+                std::ofstream parameter_file(parameter_filename);
+                parameter_file << partial_parameter;
+            }
+            camera->update_parameter(sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename));
+        };
+        if (!changes(
+                [&]() {
+                    update(
+                        "{\"change_detection\": {\"follower\": 112}, "
+                        "\"pullup\": {\"exposure_measurement_abscissa_request\": 80}}");
+                },
+                1,
+                0)) {
+            std::cerr << name << ": update_parameter did not send exactly the changed bias" << std::endl;
+            return false;
+        }
+        camera->set_bias("change_detection", "follower", 0x71);
+        if (!changes([&]() { update("{}"); }, 1, 0)) {
+            std::cerr << name << ": update_parameter did not restore the bias changed by set_bias" << std::endl;
+            return false;
+        }
+        update("{\"columns_selection\": [152, 152]}");
+        try {
+            update("{\"columns_selection\": []}");
+            std::cerr << name << ": update_parameter cleared the selection" << std::endl;
+            return false;
+        } catch (const std::runtime_error&) {
+        }
+        try {
+            camera->set_bias("change_detection", "unknown", 0);
+            std::cerr << name << ": set_bias accepted an unknown bias" << std::endl;
+            return false;
+        } catch (const std::runtime_error&) {
+        }
+    }
+    std::remove(parameter_filename.c_str());
+    if (failed.load(std::memory_order_acquire)) {
+        return false;
+    }
+    std::cout << name << ": biases and selection packs reprogrammed incrementally" << std::endl;
+    return true;
+}
+
+/// ordered_words generates pipe-out bytes with non-decreasing timestamps, ending with an overflow marker.
+/// Cameras generated with the same number of words have the same final time. The words are followed by
+/// trailing_markers overflow markers, as a running board keeps sending them, so that the replayed cameras' final
+/// times exceed the other cameras' events once their clocks are shifted onto the multi-camera's time base.
+std::vector<uint8_t> ordered_words(std::size_t number_of_words, uint32_t seed, std::size_t trailing_markers = 0) {
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<uint32_t> word_distribution;
+    std::vector<uint8_t> data;
+    data.reserve((number_of_words + trailing_markers) * 4);
+    for (std::size_t index = 0; index < number_of_words + trailing_markers; ++index) {
+        auto word = word_distribution(engine);
+        if (index % 100 == 99 || index >= number_of_words) {
+            word = 0xf0313555;
+        } else {
+            word = (word % 240) << 24 | (((word >> 8) % 304) & 0xff) << 16 | (((word >> 8) % 304) & 0x100) << 5
+                   | static_cast<uint32_t>((index % 100) * 80 + word % 80);
+        }
+        for (auto shift = 0; shift < 32; shift += 8) {
+            data.push_back(static_cast<uint8_t>(word >> shift));
+        }
+    }
+    return data;
+}
+
+/// disconnecting_front_panel replays words, and reports a different serial once they are exhausted.
+class disconnecting_front_panel : public opal_kelly_atis_sepia::replay_front_panel {
+    public:
+    disconnecting_front_panel(std::vector<uint8_t> data, std::size_t maximum_words_per_poll) :
+        replay_front_panel(std::move(data), pacing::as_fast_as_possible, maximum_words_per_poll) {}
+    disconnecting_front_panel(const disconnecting_front_panel&) = delete;
+    disconnecting_front_panel(disconnecting_front_panel&&) = delete;
+    disconnecting_front_panel& operator=(const disconnecting_front_panel&) = delete;
+    disconnecting_front_panel& operator=(disconnecting_front_panel&&) = delete;
+    virtual ~disconnecting_front_panel() {}
+
+    virtual std::string serial() override {
+        return exhausted() ? std::string() : _serial;
+    }
+};
+
+/// multi_camera merges simulated cameras, and returns false if the merged stream is not ordered, if events are
+/// lost, or if the disconnection policy is not applied. One camera is disconnected if disconnect is true.
+bool multi_camera(
+    const std::string& name,
+    bool disconnect,
+    opal_kelly_atis_sepia::disconnection_policy policy,
+    std::size_t number_of_threads) {
+    const std::size_t number_of_cameras = 3;
+    const std::size_t number_of_words = 100 * 1000;
+    std::vector<std::unique_ptr<opal_kelly_atis_sepia::front_panel>> front_panels;
+    std::size_t expected_number_of_events = 0;
+    for (std::size_t index = 0; index < number_of_cameras; ++index) {
+        const auto data = ordered_words(number_of_words, static_cast<uint32_t>(index), 64);
+        std::vector<sepia::atis_event> events(number_of_words);
+        uint64_t t_offset = 0;
+        expected_number_of_events +=
+            opal_kelly_atis_sepia::decode(data.data(), number_of_words, t_offset, events.data());
+        if (disconnect && index == 0) {
+            front_panels.push_back(sepia::make_unique<disconnecting_front_panel>(data, 1 << 10));
+        } else {
+            front_panels.push_back(sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(
+                data, opal_kelly_atis_sepia::replay_front_panel::pacing::as_fast_as_possible, 1 << (10 + index)));
+        }
+    }
+    std::array<std::size_t, number_of_cameras> events_per_camera{};
+    uint64_t previous_t = 0;
+    std::size_t disorders = 0;
+    std::atomic_bool failed(false);
+    const auto start_time = std::chrono::steady_clock::now();
+    auto camera = opal_kelly_atis_sepia::make_multi_camera(
+        [&](opal_kelly_atis_sepia::span<const opal_kelly_atis_sepia::tagged_atis_event> events) {
+            for (const auto& event : events) {
+                if (event.t < previous_t) {
+                    ++disorders;
+                }
+                previous_t = event.t;
+                ++events_per_camera.at(event.camera);
+            }
+        },
+        [&](std::exception_ptr) { failed.store(true, std::memory_order_release); },
+        std::move(front_panels),
+        std::vector<std::unique_ptr<sepia::unvalidated_parameter>>(),
+        std::chrono::hours(1),
+        number_of_threads,
+        policy,
+        1 << 20,
+        std::chrono::milliseconds(1));
+    const auto expect_failure = disconnect && policy == opal_kelly_atis_sepia::disconnection_policy::stop;
+    while (!failed.load(std::memory_order_acquire) && camera->statistics().merged_events < expected_number_of_events
+           && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(30)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto statistics = camera->statistics();
+    camera.reset();
+    if (expect_failure) {
+        if (!failed.load(std::memory_order_acquire) || statistics.connected[0]) {
+            std::cerr << name << ": the disconnection did not stop the acquisition" << std::endl;
+            return false;
+        }
+        std::cout << name << ": the disconnection stopped the acquisition" << std::endl;
+        return true;
+    }
+    if (failed.load(std::memory_order_acquire)) {
+        std::cerr << name << ": the acquisition failed" << std::endl;
+        return false;
+    }
+    if (statistics.merged_events != expected_number_of_events
+        || statistics.total.decoded_events != expected_number_of_events) {
+        std::cerr << name << ": " << statistics.merged_events << " events were merged, expected "
+                  << expected_number_of_events << std::endl;
+        return false;
+    }
+    if (disorders > 0 || statistics.late_events > 0) {
+        std::cerr << name << ": " << disorders << " events are out of order" << std::endl;
+        return false;
+    }
+    for (std::size_t index = 0; index < number_of_cameras; ++index) {
+        if (events_per_camera[index] != statistics.cameras[index].decoded_events) {
+            std::cerr << name << ": the events of camera " << index << " are mistagged" << std::endl;
+            return false;
+        }
+        if (statistics.connected[index] == (disconnect && index == 0)) {
+            std::cerr << name << ": camera " << index << " has the wrong connection state" << std::endl;
+            return false;
+        }
+    }
+    std::cout << name << ": " << statistics.merged_events << " events from " << number_of_cameras << " cameras and "
+              << number_of_threads << " polling threads" << std::endl;
+    return true;
+}
+
+/// late_front_panel replays words in real time, from the moment the camera starts the FPGA events reading, after
+/// delaying the first wire-in update, as a slow firmware upload would.
+class late_front_panel : public opal_kelly_atis_sepia::replay_front_panel {
+    public:
+    late_front_panel(std::vector<uint8_t> data, std::chrono::milliseconds delay) :
+        replay_front_panel(std::move(data), pacing::real_time),
+        _delay(delay),
+        _delayed(false),
+        _start_requested(false) {}
+    late_front_panel(const late_front_panel&) = delete;
+    late_front_panel(late_front_panel&&) = delete;
+    late_front_panel& operator=(const late_front_panel&) = delete;
+    late_front_panel& operator=(late_front_panel&&) = delete;
+    virtual ~late_front_panel() {}
+
+    virtual void set_wire_in_value(int32_t address, uint32_t value, uint32_t mask = 0xffffffff) override {
+        if (address == 0x00 && (mask & (1 << 10)) != 0) {
+            _start_requested = (value & (1 << 10)) != 0;
+        }
+    }
+    virtual void update_wire_ins() override {
+        if (!_delayed) {
+            _delayed = true;
+            std::this_thread::sleep_for(_delay);
+        }
+        if (_start_requested && !_started) {
+            _started = true;
+            _time_reference = std::chrono::steady_clock::now();
+        }
+    }
+
+    protected:
+    const std::chrono::milliseconds _delay;
+    bool _delayed;
+    bool _start_requested;
+};
+
+/// multi_camera_offsets merges simulated cameras whose boards start at different times, and returns false if the
+/// merged timestamps are not shifted onto the first board's clock, or if the merged stream is not ordered.
+bool multi_camera_offsets(const std::string& name) {
+    const std::size_t number_of_cameras = 3;
+    const std::array<std::chrono::milliseconds, number_of_cameras> delays{
+        {std::chrono::milliseconds(0), std::chrono::milliseconds(150), std::chrono::milliseconds(300)}};
+    const std::size_t number_of_words = 20 * 1000;
+    const int64_t tolerance = 25000;
+    std::vector<std::unique_ptr<opal_kelly_atis_sepia::front_panel>> front_panels;
+    std::array<uint64_t, number_of_cameras> first_ts{};
+    std::size_t expected_number_of_events = 0;
+    for (std::size_t index = 0; index < number_of_cameras; ++index) {
+        const auto data = ordered_words(number_of_words, static_cast<uint32_t>(index), 64);
+        std::vector<sepia::atis_event> events(number_of_words);
+        uint64_t t_offset = 0;
+        const auto number_of_events =
+            opal_kelly_atis_sepia::decode(data.data(), number_of_words, t_offset, events.data());
+        first_ts[index] = events.front().t;
+        expected_number_of_events += number_of_events;
+        front_panels.push_back(sepia::make_unique<late_front_panel>(data, delays[index]));
+    }
+    std::array<uint64_t, number_of_cameras> first_merged_ts{};
+    std::array<bool, number_of_cameras> merged{};
+    uint64_t previous_t = 0;
+    std::size_t disorders = 0;
+    std::atomic_bool failed(false);
+    auto camera = opal_kelly_atis_sepia::make_multi_camera(
+        [&](opal_kelly_atis_sepia::span<const opal_kelly_atis_sepia::tagged_atis_event> events) {
+            for (const auto& event : events) {
+                if (event.t < previous_t) {
+                    ++disorders;
+                }
+                previous_t = event.t;
+                if (!merged.at(event.camera)) {
+                    merged[event.camera] = true;
+                    first_merged_ts[event.camera] = event.t;
+                }
+            }
+        },
+        [&](std::exception_ptr) { failed.store(true, std::memory_order_release); },
+        std::move(front_panels),
+        std::vector<std::unique_ptr<sepia::unvalidated_parameter>>(),
+        std::chrono::seconds(1), // the first boards accumulate a backlog while the last one starts
+        number_of_cameras,
+        opal_kelly_atis_sepia::disconnection_policy::stop,
+        1 << 20,
+        std::chrono::milliseconds(1));
+    const auto start_time = std::chrono::steady_clock::now();
+    while (!failed.load(std::memory_order_acquire) && camera->statistics().merged_events < expected_number_of_events
+           && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(30)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto statistics = camera->statistics();
+    camera.reset();
+    if (failed.load(std::memory_order_acquire) || statistics.merged_events != expected_number_of_events) {
+        std::cerr << name << ": " << statistics.merged_events << " events were merged, expected "
+                  << expected_number_of_events << std::endl;
+        return false;
+    }
+    if (disorders > 0 || statistics.late_events > 0) {
+        std::cerr << name << ": " << disorders << " events are out of order and " << statistics.late_events
+                  << " events are late" << std::endl;
+        return false;
+    }
+    for (std::size_t index = 0; index < number_of_cameras; ++index) {
+        const auto shift = static_cast<int64_t>(first_merged_ts[index] - first_ts[index]);
+        const auto expected_shift = std::chrono::duration_cast<std::chrono::microseconds>(delays[index]).count();
+        if (shift < expected_shift - tolerance || shift > expected_shift + tolerance) {
+            std::cerr << name << ": the timestamps of camera " << index << " are shifted by " << shift
+                      << " us, expected " << expected_shift << " us" << std::endl;
+            return false;
+        }
+    }
+    std::cout << name << ": " << statistics.merged_events << " events from boards started up to "
+              << delays.back().count() << " ms apart" << std::endl;
+    return true;
+}
+
+/// apply_filter runs a filter on events and returns the kept events.
+template <typename Filter>
+std::vector<sepia::atis_event> apply_filter(Filter& filter, std::vector<sepia::atis_event> events) {
+    events.resize(filter(events.data(), events.size()));
+    return events;
+}
+
+/// filters checks each filter on hand-crafted events, then runs a camera with a filter chain, and returns false if
+/// the wrong events are removed.
+bool filters(const std::string& name) {
+    {
+        opal_kelly_atis_sepia::refractory_filter filter(std::chrono::microseconds(1000));
+        const auto events = apply_filter(
+            filter,
+            {{100, 5, 5, false, true},
+             {200, 5, 5, false, false},
+             {300, 6, 5, false, true},
+             {400, 5, 5, true, true},
+             {1100, 5, 5, false, true}});
+        if (events.size() != 4 || events[1].x != 6 || !events[2].is_threshold_crossing || events[3].t != 1100) {
+            std::cerr << name << ": the refractory filter kept " << events.size() << " events" << std::endl;
+            return false;
+        }
+    }
+    {
+        // the timestamps span several rebases of the filter's 32-bit table
+        opal_kelly_atis_sepia::refractory_filter filter(std::chrono::microseconds(1000));
+        const uint64_t late_t = (static_cast<uint64_t>(1) << 33) + 100;
+        const auto events = apply_filter(
+            filter,
+            {{100, 5, 5, false, true},
+             {(static_cast<uint64_t>(1) << 31) + 50, 6, 5, false, true},
+             {late_t, 5, 5, false, true},
+             {late_t + 500, 5, 5, false, true},
+             {late_t + 1000, 5, 5, false, true}});
+        if (events.size() != 4 || events[2].t != late_t || events[3].t != late_t + 1000) {
+            std::cerr << name << ": the refractory filter kept " << events.size() << " events across a rebase"
+                      << std::endl;
+            return false;
+        }
+    }
+    {
+        opal_kelly_atis_sepia::background_activity_filter filter(std::chrono::microseconds(1000));
+        const auto events = apply_filter(
+            filter,
+            {{100, 0, 0, false, true},
+             {200, 1, 1, false, true},
+             {300, 100, 100, false, true},
+             {400, 303, 239, false, true},
+             {3000, 1, 0, false, true}});
+        if (events.size() != 1 || events[0].t != 200) {
+            std::cerr << name << ": the background activity filter kept " << events.size() << " events" << std::endl;
+            return false;
+        }
+    }
+    {
+        opal_kelly_atis_sepia::hot_pixel_filter filter(std::chrono::microseconds(1000), 10.0);
+        std::vector<sepia::atis_event> calibration_events;
+        for (uint16_t index = 0; index < 100; ++index) {
+            calibration_events.push_back({static_cast<uint64_t>(index) * 10, 7, 7, false, true});
+            calibration_events.push_back({static_cast<uint64_t>(index) * 10, index, 100, false, true});
+        }
+        if (apply_filter(filter, calibration_events).size() != calibration_events.size()) {
+            std::cerr << name << ": the hot pixel filter removed events during the calibration" << std::endl;
+            return false;
+        }
+        const auto events = apply_filter(filter, {{2000, 7, 7, false, true}, {2000, 8, 7, false, true}});
+        if (filter.hot_pixels() != 1 || events.size() != 1 || events[0].x != 8) {
+            std::cerr << name << ": the hot pixel filter masked " << filter.hot_pixels() << " pixels" << std::endl;
+            return false;
+        }
+    }
+    {
+        std::vector<opal_kelly_atis_sepia::exposure_measurement> exposures;
+        auto filter = opal_kelly_atis_sepia::make_exposure_pairing(
+            [&](opal_kelly_atis_sepia::span<const opal_kelly_atis_sepia::exposure_measurement> measurements) {
+                exposures.insert(exposures.end(), measurements.begin(), measurements.end());
+            });
+        const auto events = apply_filter(
+            filter,
+            {{5, 0, 0, false, true},
+             {10, 1, 1, true, false},
+             {20, 2, 2, true, false},
+             {30, 0, 0, false, false},
+             {50, 1, 1, true, true},
+             {60, 3, 3, true, true},
+             {70, 2, 2, true, true}});
+        if (events.size() != 2 || events[0].t != 5 || events[1].t != 30 || exposures.size() != 2
+            || exposures[0].t != 50 || exposures[0].exposure != 40 || exposures[0].x != 1
+            || exposures[1].t != 70 || exposures[1].exposure != 50 || exposures[1].y != 2) {
+            std::cerr << name << ": the exposure pairing produced " << exposures.size() << " measurements"
+                      << std::endl;
+            return false;
+        }
+    }
+    {
+        opal_kelly_atis_sepia::frame_accumulator accumulator(
+            std::chrono::microseconds(1000), std::chrono::microseconds(100));
+        const auto reader = accumulator;
+        const auto events = apply_filter(
+            accumulator,
+            {{100, 5, 5, false, true},
+             {200, 5, 5, false, false},
+             {300, 6, 5, true, false},
+             {500, 6, 5, true, true},
+             {1100, 7, 5, false, true}});
+        const auto first_frame = reader.snapshot();
+        accumulator.request_snapshot();
+        apply_filter(accumulator, {{1200, 7, 5, false, true}});
+        const auto second_frame = reader.snapshot();
+        // idle polls call the filters without events
+        accumulator.request_snapshot();
+        apply_filter(accumulator, {});
+        const auto requested_frame = reader.snapshot();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        apply_filter(accumulator, {});
+        const auto idle_frame = reader.snapshot();
+        const auto pixel = [](uint16_t x, uint16_t y) {
+            return static_cast<std::size_t>(x) + static_cast<std::size_t>(y) * opal_kelly_atis_sepia::camera::width();
+        };
+        if (events.size() != 5 || !first_frame || !second_frame || first_frame == second_frame
+            || first_frame->t != 500 || first_frame->counts[pixel(5, 5)] != 2 || first_frame->ts[pixel(5, 5)] != 200
+            || first_frame->ts[pixel(7, 5)] != opal_kelly_atis_sepia::frame::no_event()
+            || first_frame->exposures[pixel(6, 5)] != 200
+            || std::abs(first_frame->time_surface[pixel(5, 5)] - std::exp(-3.0f)) > 1e-6f
+            || first_frame->time_surface[pixel(6, 5)] != 0.0f || second_frame->t != 1100
+            || second_frame->counts[pixel(5, 5)] != 0 || second_frame->counts[pixel(7, 5)] != 1
+            || second_frame->time_surface[pixel(7, 5)] != 1.0f || requested_frame == second_frame
+            || requested_frame->t != 1200 || idle_frame == requested_frame || idle_frame->t != 1200) {
+            std::cerr << name << ": the frame accumulator published wrong frames" << std::endl;
+            return false;
+        }
+    }
+    const auto data = synthetic_words(1 << 20);
+    std::atomic<std::size_t> number_of_events(0);
+    std::atomic_bool failed(false);
+    opal_kelly_atis_sepia::frame_accumulator accumulator(
+        std::chrono::microseconds(10000), std::chrono::microseconds(1000));
+    auto camera = opal_kelly_atis_sepia::make_batch_camera(
+        [&](opal_kelly_atis_sepia::span<const sepia::atis_event> events) {
+            number_of_events.fetch_add(events.size(), std::memory_order_relaxed);
+        },
+        [&](std::exception_ptr) { failed.store(true, std::memory_order_release); },
+        sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(
+            data, opal_kelly_atis_sepia::replay_front_panel::pacing::as_fast_as_possible),
+        std::unique_ptr<sepia::unvalidated_parameter>(),
+        1 << 24,
+        std::chrono::milliseconds(1),
+        opal_kelly_atis_sepia::make_filter_chain(
+            accumulator,
+            opal_kelly_atis_sepia::refractory_filter(std::chrono::microseconds(100)),
+            opal_kelly_atis_sepia::background_activity_filter(std::chrono::microseconds(1000))));
+    const auto start_time = std::chrono::steady_clock::now();
+    for (;;) {
+        const auto statistics = camera->statistics();
+        if (statistics.decoded_events + statistics.dropped_words + statistics.overflow_markers == data.size() / 4
+            && statistics.pushed_events + statistics.filtered_events == statistics.decoded_events
+            && number_of_events.load() == statistics.pushed_events) {
+            break;
+        }
+        if (failed.load(std::memory_order_acquire)
+            || std::chrono::steady_clock::now() - start_time > std::chrono::seconds(30)) {
+            std::cerr << name << ": the filtered acquisition did not complete" << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto statistics = camera->statistics();
+    if (statistics.filtered_events == 0 || statistics.pushed_events == 0) {
+        std::cerr << name << ": " << statistics.filtered_events << " of " << statistics.decoded_events
+                  << " events were filtered, " << statistics.pushed_events << " were pushed" << std::endl;
+        return false;
+    }
+    const auto frame = accumulator.snapshot();
+    if (!frame || frame->t == 0
+        || std::all_of(frame->ts.begin(), frame->ts.end(), [](uint64_t t) {
+               return t == opal_kelly_atis_sepia::frame::no_event();
+           })) {
+        std::cerr << name << ": the frame accumulator did not publish frames during the acquisition" << std::endl;
+        return false;
+    }
+    accumulator.request_snapshot();
+    while (accumulator.snapshot() == frame) {
+        if (std::chrono::steady_clock::now() - start_time > std::chrono::seconds(30)) {
+            std::cerr << name << ": the frame accumulator did not publish frames while the board was idle"
+                      << std::endl;
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::cout << name << ": " << statistics.filtered_events << " of " << statistics.decoded_events
+              << " events filtered" << std::endl;
+    return true;
+}
+
+/// decode_mode_camera runs a camera which decodes only change detections, and returns false if its handler does
+/// not receive exactly the change detections of the data.
+bool decode_mode_camera(const std::string& name) {
+    const auto data = synthetic_words(1 << 20);
+    std::vector<sepia::dvs_event> expected_events(data.size() / 4);
+    uint64_t t_offset = 0;
+    std::size_t number_of_threshold_crossings = 0;
+    expected_events.resize(opal_kelly_atis_sepia::decode<opal_kelly_atis_sepia::dvs_mode>(
+        data.data(), data.size() / 4, t_offset, expected_events.data(), &number_of_threshold_crossings));
+    std::vector<sepia::dvs_event> events;
+    std::atomic<std::size_t> number_of_events(0);
+    std::atomic_bool failed(false);
+    opal_kelly_atis_sepia::acquisition_statistics statistics;
+    {
+        auto camera = opal_kelly_atis_sepia::make_batch_camera<opal_kelly_atis_sepia::dvs_mode>(
+            [&](opal_kelly_atis_sepia::span<const sepia::dvs_event> batch) {
+                events.insert(events.end(), batch.begin(), batch.end());
+                number_of_events.store(events.size(), std::memory_order_release);
+            },
+            [&](std::exception_ptr) { failed.store(true, std::memory_order_release); },
+            sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(
+                data, opal_kelly_atis_sepia::replay_front_panel::pacing::as_fast_as_possible),
+            std::unique_ptr<sepia::unvalidated_parameter>(),
+            1 << 24,
+            std::chrono::milliseconds(1));
+        const auto start_time = std::chrono::steady_clock::now();
+        while (number_of_events.load(std::memory_order_acquire) < expected_events.size()
+               && !failed.load(std::memory_order_acquire)
+               && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(30)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        statistics = camera->statistics();
+    }
+    if (failed.load(std::memory_order_acquire) || events.size() != expected_events.size()
+        || !std::equal(
+            events.begin(),
+            events.end(),
+            expected_events.begin(),
+            [](const sepia::dvs_event& event, const sepia::dvs_event& expected_event) {
+                return event.t == expected_event.t && event.x == expected_event.x && event.y == expected_event.y
+                       && event.is_increase == expected_event.is_increase;
+            })) {
+        std::cerr << name << ": " << events.size() << " DVS events were received, expected "
+                  << expected_events.size() << std::endl;
+        return false;
+    }
+    const auto number_of_markers = t_offset / 0x2000;
+    if (statistics.mode_discarded_events != number_of_threshold_crossings
+        || statistics.dropped_words
+               != data.size() / 4 - expected_events.size() - number_of_threshold_crossings - number_of_markers) {
+        std::cerr << name << ": " << statistics.mode_discarded_events << " threshold crossings and "
+                  << statistics.dropped_words << " out-of-range words were counted" << std::endl;
+        return false;
+    }
+    std::cout << name << ": " << events.size() << " DVS events" << std::endl;
+    return true;
+}
+
+/// memory_budget runs a compact-mode camera with a capped read buffer and huge pages, and checks the events, the
+/// read sizes and the memory report.
+bool memory_budget(const std::string& name) {
+    const auto data = synthetic_words(1 << 20);
+    std::vector<sepia::atis_event> expected_events(data.size() / 4);
+    uint64_t t_offset = 0;
+    expected_events.resize(
+        opal_kelly_atis_sepia::decode(data.data(), data.size() / 4, t_offset, expected_events.data()));
+    const auto parameter_filename = name + ".json";
+    {
+        std::ofstream parameter_file(parameter_filename);
+        parameter_file << "{\"acquisition\": {\"read_buffer_words\": 4096, \"huge_pages\": true}}";
+    }
+    std::vector<sepia::atis_event> events;
+    std::atomic<std::size_t> number_of_events(0);
+    std::atomic_bool failed(false);
+    opal_kelly_atis_sepia::acquisition_statistics statistics;
+    opal_kelly_atis_sepia::memory_statistics memory;
+    {
+        auto camera = opal_kelly_atis_sepia::make_batch_camera<opal_kelly_atis_sepia::compact_mode>(
+            [&](opal_kelly_atis_sepia::span<const opal_kelly_atis_sepia::compact_atis_event> batch) {
+                for (const auto event : batch) {
+                    events.push_back(opal_kelly_atis_sepia::unpack(event));
+                }
+                number_of_events.store(events.size(), std::memory_order_release);
+            },
+            [&](std::exception_ptr) { failed.store(true, std::memory_order_release); },
+            sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(
+                data, opal_kelly_atis_sepia::replay_front_panel::pacing::as_fast_as_possible),
+            sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+            1 << 20,
+            std::chrono::milliseconds(1));
+        const auto start_time = std::chrono::steady_clock::now();
+        while (number_of_events.load(std::memory_order_acquire) < expected_events.size()
+               && !failed.load(std::memory_order_acquire)
+               && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(30)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        statistics = camera->statistics();
+        memory = camera->memory();
+    }
+    std::remove(parameter_filename.c_str());
+    if (failed.load(std::memory_order_acquire) || events.size() != expected_events.size()
+        || !std::equal(
+            events.begin(),
+            events.end(),
+            expected_events.begin(),
+            [](const sepia::atis_event& event, const sepia::atis_event& expected_event) {
+                return event.t == expected_event.t && event.x == expected_event.x && event.y == expected_event.y
+                       && event.is_threshold_crossing == expected_event.is_threshold_crossing
+                       && event.polarity == expected_event.polarity;
+            })) {
+        std::cerr << name << ": " << events.size() << " compact events were received, expected "
+                  << expected_events.size() << std::endl;
+        return false;
+    }
+    for (std::size_t index = 13; index < statistics.read_sizes.size(); ++index) {
+        if (statistics.read_sizes[index] > 0) {
+            std::cerr << name << ": a read exceeded the read buffer" << std::endl;
+            return false;
+        }
+    }
+    if (memory.allocated_read_buffers_bytes != 4096 * 4
+        || memory.allocated_fifo_bytes != (1 << 20) * sizeof(opal_kelly_atis_sepia::compact_atis_event)
+        || memory.resident_read_buffers_bytes > memory.allocated_read_buffers_bytes
+        || memory.resident_fifo_bytes > memory.allocated_fifo_bytes || memory.resident_fifo_bytes == 0) {
+        std::cerr << name << ": the memory report does not match the buffers" << std::endl;
+        return false;
+    }
+    std::cout << name << ": " << events.size() << " compact events, " << memory.resident_fifo_bytes / 1024
+              << " KiB of " << memory.allocated_fifo_bytes / 1024 << " KiB resident in the FIFO" << std::endl;
+    return true;
+}
+
+/// overflow runs a batch camera with a small FIFO and a handler which blocks until the words are read (or for at most
+/// 200 ms), and checks that the overflow policy accounts for every event.
+/// If lossless is true, every event must be received in order, otherwise the received events must be a subsequence of
+/// the expected ones, and the drops must be counted as overflow episodes. The exception handler must not be called,
+/// and the drop handler must not be called more than once per episode.
+bool overflow(const std::string& name, const std::string& policy, bool lossless) {
+    const auto data = synthetic_words(1 << 18);
+    std::vector<sepia::atis_event> expected_events(data.size() / 4);
+    uint64_t t_offset = 0;
+    expected_events.resize(
+        opal_kelly_atis_sepia::decode(data.data(), data.size() / 4, t_offset, expected_events.data()));
+    const auto parameter_filename = name + ".json";
+    {
+        std::ofstream parameter_file(parameter_filename);
+        parameter_file << "{\"acquisition\": {\"overflow\": {\"policy\": \"" << policy << "\"}}}";
+    }
+    std::vector<sepia::atis_event> events;
+    std::atomic<std::size_t> number_of_events(0);
+    std::atomic_bool released(false);
+    std::atomic_bool failed(false);
+    std::atomic<std::size_t> number_of_reports(0);
+    opal_kelly_atis_sepia::acquisition_statistics statistics;
+    {
+        auto camera = opal_kelly_atis_sepia::make_batch_camera(
+            [&](opal_kelly_atis_sepia::span<const sepia::atis_event> batch) {
+                while (!released.load(std::memory_order_acquire)) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                events.insert(events.end(), batch.begin(), batch.end());
+                number_of_events.store(events.size(), std::memory_order_release);
+            },
+            [&](std::exception_ptr exception) {
+                try {
+                    std::rethrow_exception(exception);
+                } catch (const std::exception& caught_exception) {
+                    std::cerr << name << ": " << caught_exception.what() << std::endl;
+                    failed.store(true, std::memory_order_release);
+                }
+            },
+            sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(
+                data, opal_kelly_atis_sepia::replay_front_panel::pacing::as_fast_as_possible, 1 << 12),
+            sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+            1 << 14,
+            std::chrono::milliseconds(1));
+        camera->set_drop_handler([&](const opal_kelly_atis_sepia::events_dropped&) {
+            number_of_reports.fetch_add(1, std::memory_order_acq_rel);
+        });
+        const auto start_time = std::chrono::steady_clock::now();
+        for (;;) {
+            statistics = camera->statistics();
+            if (failed.load(std::memory_order_acquire)
+                || std::chrono::steady_clock::now() - start_time > std::chrono::seconds(30)) {
+                break;
+            }
+            if (statistics.read_bytes == data.size()
+                || std::chrono::steady_clock::now() - start_time > std::chrono::milliseconds(200)) {
+                released.store(true, std::memory_order_release);
+            }
+            if (released.load(std::memory_order_acquire) && statistics.read_bytes == data.size()
+                && number_of_events.load(std::memory_order_acquire) + statistics.overflow_dropped_events
+                           + statistics.overflow_discarded_events
+                       == expected_events.size()) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    std::remove(parameter_filename.c_str());
+    if (failed.load(std::memory_order_acquire)
+        || events.size() + statistics.overflow_dropped_events + statistics.overflow_discarded_events
+               != expected_events.size()) {
+        std::cerr << name << ": " << events.size() << " events were received and "
+                  << statistics.overflow_dropped_events + statistics.overflow_discarded_events
+                  << " dropped, expected " << expected_events.size() << std::endl;
+        return false;
+    }
+    const auto same = [](const sepia::atis_event& event, const sepia::atis_event& expected_event) {
+        return event.t == expected_event.t && event.x == expected_event.x && event.y == expected_event.y
+               && event.is_threshold_crossing == expected_event.is_threshold_crossing
+               && event.polarity == expected_event.polarity;
+    };
+    if (lossless) {
+        if (!std::equal(events.begin(), events.end(), expected_events.begin(), same)
+            || statistics.overflow_episodes > 0 || number_of_reports.load() > 0) {
+            std::cerr << name << ": the events do not match" << std::endl;
+            return false;
+        }
+    } else {
+        auto expected_event = expected_events.begin();
+        for (const auto& event : events) {
+            expected_event = std::find_if(expected_event, expected_events.end(), [&](const sepia::atis_event& other) {
+                return same(event, other);
+            });
+            if (expected_event == expected_events.end()) {
+                std::cerr << name << ": the events are not a subsequence of the expected events" << std::endl;
+                return false;
+            }
+            ++expected_event;
+        }
+        if (statistics.overflow_episodes == 0 || number_of_reports.load() > statistics.overflow_episodes
+            || events.size() == expected_events.size()) {
+            std::cerr << name << ": the overflow was not reported" << std::endl;
+            return false;
+        }
+    }
+    std::cout << name << ": " << events.size() << " events received, "
+              << statistics.overflow_dropped_events + statistics.overflow_discarded_events << " dropped, "
+              << statistics.spilled_words << " words spilled" << std::endl;
+    return true;
+}
+
+/// pull_camera reads a replay with a pull camera whose descriptor is polled, and checks the events, the number of
+/// notifications and the reading thread's placement.
+bool pull_camera(
+    const std::string& name,
+    const std::vector<uint8_t>& data,
+    opal_kelly_atis_sepia::replay_front_panel::pacing pacing,
+    std::size_t batch_events,
+    std::size_t minimum_number_of_notifications) {
+    std::vector<sepia::atis_event> expected_events(data.size() / 4);
+    uint64_t t_offset = 0;
+    expected_events.resize(
+        opal_kelly_atis_sepia::decode(data.data(), data.size() / 4, t_offset, expected_events.data()));
+    auto cpu = -1;
+#ifdef __linux__
+    {
+        cpu_set_t cpus;
+        if (sched_getaffinity(0, sizeof(cpu_set_t), &cpus) == 0) {
+            for (auto index = 0; index < CPU_SETSIZE; ++index) {
+                if (CPU_ISSET(index, &cpus)) {
+                    cpu = index;
+                    break;
+                }
+            }
+        }
+    }
+#endif
+    const auto parameter_filename = name + ".json";
+    {
+        std::ofstream parameter_file(parameter_filename);
+        parameter_file << "{\"acquisition\": {\"threads\": {\"reading_cpu\": " << cpu
+                       << ", \"scheduling\": \"fifo\"}}}";
+    }
+    std::vector<sepia::atis_event> events;
+    std::size_t number_of_notifications = 0;
+    opal_kelly_atis_sepia::placement_report placement;
+    {
+        auto camera = opal_kelly_atis_sepia::make_pull_camera(
+            sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(data, pacing, 1 << 16),
+            sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+            batch_events,
+            std::chrono::microseconds(2000),
+            1 << 22);
+        std::vector<sepia::atis_event> buffer(1 << 12);
+        pollfd descriptor;
+        descriptor.fd = camera->file_descriptor();
+        descriptor.events = POLLIN;
+        const auto start_time = std::chrono::steady_clock::now();
+        try {
+            while (events.size() < expected_events.size()
+                   && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(30)) {
+                if (::poll(&descriptor, 1, 100) > 0 && (descriptor.revents & POLLIN)) {
+                    ++number_of_notifications;
+                    for (;;) {
+                        const auto number_of_events = camera->drain(
+                            opal_kelly_atis_sepia::span<sepia::atis_event>(buffer.data(), buffer.size()));
+                        if (number_of_events == 0) {
+                            break;
+                        }
+                        events.insert(events.end(), buffer.begin(), buffer.begin() + number_of_events);
+                    }
+                }
+            }
+        } catch (const std::exception& exception) {
+            std::cerr << name << ": " << exception.what() << std::endl;
+            return false;
+        }
+        placement = camera->placement();
+    }
+    std::remove(parameter_filename.c_str());
+    if (events.size() != expected_events.size()
+        || !std::equal(
+            events.begin(),
+            events.end(),
+            expected_events.begin(),
+            [](const sepia::atis_event& event, const sepia::atis_event& expected_event) {
+                return event.t == expected_event.t && event.x == expected_event.x && event.y == expected_event.y
+                       && event.is_threshold_crossing == expected_event.is_threshold_crossing
+                       && event.polarity == expected_event.polarity;
+            })) {
+        std::cerr << name << ": " << events.size() << " events were drained, expected " << expected_events.size()
+                  << std::endl;
+        return false;
+    }
+    if (number_of_notifications < minimum_number_of_notifications) {
+        std::cerr << name << ": " << number_of_notifications << " notifications, expected at least "
+                  << minimum_number_of_notifications << std::endl;
+        return false;
+    }
+    if (placement.reading.cpu != cpu || placement.decoding.cpu != -1 || placement.dispatching.cpu != -1) {
+        std::cerr << name << ": the reading thread was not pinned to core " << cpu << std::endl;
+        return false;
+    }
+    std::cout << name << ": " << events.size() << " events drained after " << number_of_notifications
+              << " notifications, reading thread on core " << placement.reading.cpu
+              << (placement.reading.real_time ? " with" : " without") << " real-time scheduling" << std::endl;
+    return true;
+}
+
+/// first_and_last_events runs a batch camera on a replay whose reads are limited to a link bandwidth, and measures
+/// the time from the camera's creation to the first and last received events. It returns false if the acquisition
+/// does not complete.
+bool first_and_last_events(
+    const std::string& name,
+    const std::string& json_parameter,
+    const std::vector<uint8_t>& data,
+    std::size_t number_of_expected_events,
+    std::chrono::microseconds& first_event_latency,
+    std::chrono::microseconds& last_event_latency) {
+    const auto parameter_filename = name + ".json";
+    {
+        std::ofstream parameter_file(parameter_filename);
+        parameter_file << json_parameter;
+    }
+    std::atomic<std::size_t> number_of_events(0);
+    std::atomic_bool failed(false);
+    std::chrono::steady_clock::time_point first_event_time;
+    std::chrono::steady_clock::time_point last_event_time;
+    const auto start_time = std::chrono::steady_clock::now();
+    {
+        auto camera = opal_kelly_atis_sepia::make_batch_camera(
+            [&](opal_kelly_atis_sepia::span<const sepia::atis_event> batch) {
+                const auto now = std::chrono::steady_clock::now();
+                if (number_of_events.load(std::memory_order_relaxed) == 0) {
+                    first_event_time = now;
+                }
+                last_event_time = now;
+                number_of_events.store(
+                    number_of_events.load(std::memory_order_relaxed) + batch.size(), std::memory_order_release);
+            },
+            [&](std::exception_ptr) { failed.store(true, std::memory_order_release); },
+            sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(
+                data,
+                opal_kelly_atis_sepia::replay_front_panel::pacing::as_fast_as_possible,
+                1 << 24,
+                "replay",
+                5e8),
+            sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename),
+            1 << 24,
+            std::chrono::milliseconds(1));
+        while (number_of_events.load(std::memory_order_acquire) < number_of_expected_events
+               && !failed.load(std::memory_order_acquire)
+               && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(30)) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    std::remove(parameter_filename.c_str());
+    if (number_of_events.load(std::memory_order_acquire) != number_of_expected_events) {
+        std::cerr << name << ": received " << number_of_events.load() << " events, expected "
+                  << number_of_expected_events << std::endl;
+        return false;
+    }
+    first_event_latency = std::chrono::duration_cast<std::chrono::microseconds>(first_event_time - start_time);
+    last_event_latency = std::chrono::duration_cast<std::chrono::microseconds>(last_event_time - start_time);
+    return true;
+}
+
+/// streaming_latency reads a large backlog over a simulated link, in one transfer and in streaming chunks, and
+/// checks that streaming delivers the first events much earlier without lowering the throughput.
+bool streaming_latency(const std::string& name) {
+    const auto data = synthetic_words(1 << 22);
+    std::vector<sepia::atis_event> expected_events(data.size() / 4);
+    uint64_t t_offset = 0;
+    expected_events.resize(
+        opal_kelly_atis_sepia::decode(data.data(), data.size() / 4, t_offset, expected_events.data()));
+    std::chrono::microseconds transfer_first;
+    std::chrono::microseconds transfer_last;
+    std::chrono::microseconds streaming_first;
+    std::chrono::microseconds streaming_last;
+    if (!first_and_last_events(
+            name + "_transfer",
+            "{\"acquisition\": {\"pipelined\": false}}",
+            data,
+            expected_events.size(),
+            transfer_first,
+            transfer_last)
+        || !first_and_last_events(
+            name + "_streaming",
+            "{\"acquisition\": {\"streaming\": {\"chunk_words\": 65536, \"block_size\": 1024}}}",
+            data,
+            expected_events.size(),
+            streaming_first,
+            streaming_last)) {
+        return false;
+    }
+    if (streaming_first * 4 > transfer_first || streaming_last > transfer_last + transfer_last / 2) {
+        std::cerr << name << ": the first and last events arrived after " << streaming_first.count() << " us and "
+                  << streaming_last.count() << " us with streaming, " << transfer_first.count() << " us and "
+                  << transfer_last.count() << " us without" << std::endl;
+        return false;
+    }
+    std::cout << name << ": first event after " << streaming_first.count() << " us (" << transfer_first.count()
+              << " us without streaming), last event after " << streaming_last.count() / 1000 << " ms ("
+              << transfer_last.count() / 1000 << " ms without streaming)" << std::endl;
+    return true;
+}
+
+/// invalid_block_size returns false if a camera accepts a block size smaller than the Opal Kelly minimum.
+bool invalid_block_size(const std::string& name) {
+    const auto parameter_filename = name + ".json";
+    {
+        std::ofstream parameter_file(parameter_filename);
+        parameter_file << "{\"acquisition\": {\"streaming\": {\"chunk_words\": 4096, \"block_size\": 8}}}";
+    }
+    auto rejected = false;
+    try {
+        opal_kelly_atis_sepia::make_batch_camera(
+            [](opal_kelly_atis_sepia::span<const sepia::atis_event>) {},
+            [](std::exception_ptr) {},
+            sepia::make_unique<opal_kelly_atis_sepia::replay_front_panel>(
+                synthetic_words(1 << 10), opal_kelly_atis_sepia::replay_front_panel::pacing::as_fast_as_possible),
+            sepia::make_unique<sepia::unvalidated_parameter>(parameter_filename));
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    std::remove(parameter_filename.c_str());
+    if (!rejected) {
+        std::cerr << name << ": a block size of 8 bytes was accepted" << std::endl;
+        return false;
+    }
+    std::cout << name << ": a block size of 8 bytes was rejected" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    const auto data = synthetic_words(1 << 21);
+    const auto as_fast_as_possible = opal_kelly_atis_sepia::replay_front_panel::pacing::as_fast_as_possible;
+    const std::string pipelined_parameter(
+        "{\"acquisition\": {\"pipelined\": true, \"transfer_buffers\": 3, \"transfer_buffer_words\": 4096}}");
+    if (!acquire(
+            "single_thread", "{\"acquisition\": {\"pipelined\": false}}", data, as_fast_as_possible, 1 << 16, false)) {
+        return 1;
+    }
+    if (!acquire("pipelined", pipelined_parameter, data, as_fast_as_possible, 1 << 16, false)) {
+        return 1;
+    }
+    if (!acquire("batch", "{\"acquisition\": {\"pipelined\": false}}", data, as_fast_as_possible, 1 << 16, true)) {
+        return 1;
+    }
+    if (!acquire("pipelined_batch", pipelined_parameter, data, as_fast_as_possible, 1 << 16, true)) {
+        return 1;
+    }
+    if (!acquire(
+            "parallel_decoding",
+            "{\"acquisition\": {\"decoding\": {\"threads\": 4, \"minimum_words\": 1024}}}",
+            data,
+            as_fast_as_possible,
+            (1 << 16) + 5,
+            true)) {
+        return 1;
+    }
+    if (!acquire(
+            "streaming",
+            "{\"acquisition\": {\"streaming\": {\"chunk_words\": 4096, \"block_size\": 1024}}}",
+            data,
+            as_fast_as_possible,
+            1 << 18,
+            true)) {
+        return 1;
+    }
+    if (!acquire(
+            "streaming_partial_block",
+            "{\"acquisition\": {\"streaming\": {\"chunk_words\": 4096, \"block_size\": 1024}}}",
+            synthetic_words((1 << 16) + 96),
+            as_fast_as_possible,
+            1 << 18,
+            true)) {
+        return 1;
+    }
+    if (!invalid_block_size("invalid_block_size")) {
+        return 1;
+    }
+    if (!acquire(
+            "adaptive_polling",
+            "{\"acquisition\": {\"polling\": {\"policy\": \"adaptive\", \"latency_target\": 500}}}",
+            data,
+            as_fast_as_possible,
+            1 << 16,
+            true)) {
+        return 1;
+    }
+    if (!acquire(
+            "real_time",
+            "{\"acquisition\": {\"polling\": {\"policy\": \"adaptive\", \"latency_target\": 1000}}}",
+            synthetic_words(6000),
+            opal_kelly_atis_sepia::replay_front_panel::pacing::real_time,
+            1 << 24,
+            true)) {
+        return 1;
+    }
+    if (!startup("startup")) {
+        return 1;
+    }
+    if (!reprogram("reprogram")) {
+        return 1;
+    }
+    if (!filters("filters")) {
+        return 1;
+    }
+    if (!decode_mode_camera("decode_mode_camera")) {
+        return 1;
+    }
+    if (!memory_budget("memory_budget")) {
+        return 1;
+    }
+    if (!streaming_latency("streaming_latency")) {
+        return 1;
+    }
+    if (!pull_camera("pull_camera", synthetic_words((1 << 20) + 12345), as_fast_as_possible, 1 << 14, 1)
+        || !pull_camera(
+            "pull_camera_latency",
+            synthetic_words(6000),
+            opal_kelly_atis_sepia::replay_front_panel::pacing::real_time,
+            1 << 20,
+            10)) {
+        return 1;
+    }
+    if (!overflow("overflow_drop_newest", "drop_newest", false)
+        || !overflow("overflow_drop_oldest", "drop_oldest", false)
+        || !overflow("overflow_drop_threshold_crossings", "drop_threshold_crossings", false)
+        || !overflow("overflow_back_pressure", "back_pressure", true) || !overflow("overflow_spill", "spill", true)) {
+        return 1;
+    }
+    if (!multi_camera("multi_camera", false, opal_kelly_atis_sepia::disconnection_policy::stop, 2)) {
+        return 1;
+    }
+    if (!multi_camera(
+            "multi_camera_continue_without",
+            true,
+            opal_kelly_atis_sepia::disconnection_policy::continue_without,
+            1)) {
+        return 1;
+    }
+    if (!multi_camera("multi_camera_stop", true, opal_kelly_atis_sepia::disconnection_policy::stop, 3)) {
+        return 1;
+    }
+    if (!multi_camera_offsets("multi_camera_offsets")) {
+        return 1;
+    }
+    if (!record("raw_synchronous", "{\"acquisition\": {\"raw\": {\"asynchronous_writes\": false}}}")) {
+        return 1;
+    }
+    if (!record(
+            "raw_direct_pipelined",
+            "{\"acquisition\": {\"pipelined\": true, \"raw\": {\"direct_io\": true, \"block_size\": 65536}}}")) {
+        return 1;
+    }
+    return 0;
+}